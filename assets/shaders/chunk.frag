@@ -0,0 +1,19 @@
+#version 460
+
+// one layer per block texture, see Minecraft::Assets::TextureArray
+layout (binding = 1) uniform sampler2DArray s_blocks;
+
+in vec2 texCoord;
+flat in uint tile;
+in float shade;
+
+out vec4 fragColor;
+
+void main() {
+	// every layer repeats on its own, so merged quads spanning multiple blocks don't need to wrap the texcoord
+	vec4 c = texture(s_blocks, vec3(texCoord, tile));
+	if (c.a < 0.01)
+		discard;
+
+	fragColor = vec4(c.rgb * shade, c.a);
+}
@@ -0,0 +1,53 @@
+#version 460
+
+// see Minecraft::World::ChunkVertex for the layout
+layout (location = 0) in uvec2 a_data;
+
+// world position of the section of every draw, indexed by gl_DrawID, see Minecraft::Render::ChunkRenderer
+layout (std430, binding = 0) readonly buffer Sections {
+	ivec4 origins[];
+};
+
+// shared by every program, see Minecraft::Assets::CameraBuffer
+layout (std140, binding = 1) uniform Camera {
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	mat4 viewProjectionMatrix;
+	vec4 cameraPosition;
+};
+
+// in the order of Minecraft::World::Face
+const float faceShade[6] = float[](0.8, 0.8, 0.5, 1.0, 0.6, 0.6);
+// texture axes per face as (u axis, u sign, v axis, v sign),
+// so side textures are upright and not mirrored when looked at from outside
+const ivec4 faceTexcoords[6] = ivec4[](
+	ivec4(2, +1, 1, -1),
+	ivec4(2, -1, 1, -1),
+	ivec4(0, +1, 2, -1),
+	ivec4(0, +1, 2, +1),
+	ivec4(0, -1, 1, -1),
+	ivec4(0, +1, 1, -1)
+);
+const float aoCurve[4] = float[](0.45, 0.65, 0.85, 1.0);
+
+out vec2 texCoord;
+flat out uint tile;
+out float shade;
+
+void main() {
+	vec3 position = vec3(a_data.x & 0x1Fu, (a_data.x >> 5) & 0x1Fu, (a_data.x >> 10) & 0x1Fu);
+	uint face = (a_data.x >> 15) & 0x7u;
+	uint ao = (a_data.x >> 18) & 0x3u;
+
+	uint blockLight = (a_data.y >> 16) & 0xFu;
+	uint skyLight = (a_data.y >> 20) & 0xFu;
+
+	ivec4 axes = faceTexcoords[face];
+	texCoord = vec2(position[axes.x] * axes.y, position[axes.z] * axes.w);
+	tile = a_data.y & 0xFFFFu;
+
+	float light = max(blockLight, skyLight) / 15.0;
+	shade = faceShade[face] * aoCurve[ao] * max(light, 0.05);
+
+	gl_Position = viewProjectionMatrix * vec4(position + vec3(origins[gl_DrawID].xyz), 1);
+}
@@ -4,9 +4,15 @@ layout (location = 0) in vec3 a_position;
 layout (location = 1) in vec4 a_color;
 layout (location = 2) in vec2 a_texcoord;
 
+// shared by every program, see Minecraft::Assets::CameraBuffer
+layout (std140, binding = 1) uniform Camera {
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	mat4 viewProjectionMatrix;
+	vec4 cameraPosition;
+};
+
 uniform mat4 modelMatrix = mat4(1.0);
-uniform mat4 viewMatrix = mat4(1.0);
-uniform mat4 projectionMatrix = mat4(1.0);
 uniform float time = 0;
 
 out vec4 color;
@@ -19,5 +25,5 @@ void main() {
 
 	color = a_color;
 	texCoord = a_texcoord;
-	gl_Position = projectionMatrix * viewMatrix * modelMatrix  * vec4(position, 1);
+	gl_Position = viewProjectionMatrix * modelMatrix * vec4(position, 1);
 }
@@ -0,0 +1,166 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numeric>
+#include <string_view>
+#include <thread>
+
+namespace Minecraft::Bench {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		std::string escape(std::string_view text) {
+			std::string escaped;
+			for (char c : text) {
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+
+		/// nanoseconds with a unit that keeps the number readable
+		std::string formatTime(double nanoseconds) {
+			if (nanoseconds < 1e3)
+				return std::format("{:.1f} ns", nanoseconds);
+			if (nanoseconds < 1e6)
+				return std::format("{:.2f} us", nanoseconds / 1e3);
+			return std::format("{:.2f} ms", nanoseconds / 1e6);
+		}
+
+		std::string formatThroughput(double perSecond, const std::string& itemName) {
+			if (perSecond >= 1e9)
+				return std::format("{:.2f} G{}/s", perSecond / 1e9, itemName);
+			if (perSecond >= 1e6)
+				return std::format("{:.2f} M{}/s", perSecond / 1e6, itemName);
+			if (perSecond >= 1e3)
+				return std::format("{:.2f} k{}/s", perSecond / 1e3, itemName);
+			return std::format("{:.2f} {}/s", perSecond, itemName);
+		}
+
+		std::string getCompiler() {
+#if defined(__clang__)
+			return std::format("clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+			return std::format("gcc {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+			return std::format("msvc {}", _MSC_VER);
+#else
+			return "unknown";
+#endif
+		}
+	}
+
+	double Result::getThroughput() const {
+		return median > 0 ? itemsPerIteration * 1e9 / median : 0;
+	}
+
+	Runner::Runner(Options options) : options(std::move(options)) {
+	}
+
+	void Runner::run(const std::string& name, size_t itemsPerIteration, const std::string& itemName, const std::function<void()>& function) {
+		if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+			return;
+
+		// the warmup also measures how long an iteration takes, to decide how many go in a sample
+		size_t warmupIterations = 0;
+		Clock::time_point warmupStart = Clock::now();
+		Clock::duration warmupTime;
+		do {
+			function();
+			warmupIterations++;
+			warmupTime = Clock::now() - warmupStart;
+		} while (warmupTime < options.warmup);
+
+		Result result;
+		result.name = name;
+		result.itemsPerIteration = itemsPerIteration;
+		result.itemName = itemName;
+		double iterationTime = std::chrono::duration<double, std::nano>(warmupTime).count() / warmupIterations;
+		result.iterations = std::max<size_t>(1, size_t(std::ceil(std::chrono::duration<double, std::nano>(options.minSampleTime).count() / iterationTime)));
+
+		for (size_t sample = 0; sample < std::max<size_t>(1, options.repetitions); sample++) {
+			Clock::time_point start = Clock::now();
+			for (size_t i = 0; i < result.iterations; i++)
+				function();
+			result.samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / result.iterations);
+		}
+
+		std::vector<double> sorted = result.samples;
+		std::ranges::sort(sorted);
+		size_t count = sorted.size();
+
+		result.min = sorted.front();
+		result.max = sorted.back();
+		result.median = count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+		result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / count;
+
+		double variance = 0;
+		for (double sample : sorted)
+			variance += (sample - result.mean) * (sample - result.mean);
+		result.standardDeviation = count > 1 ? std::sqrt(variance / (count - 1)) : 0;
+
+		results.push_back(std::move(result));
+	}
+
+	const std::vector<Result>& Runner::getResults() const {
+		return results;
+	}
+
+	void Runner::writeTable(std::ostream& out) const {
+		size_t nameWidth = 0;
+		for (const Result& result : results)
+			nameWidth = std::max(nameWidth, result.name.size());
+
+		out << std::format("{:<{}}  {:>12}  {:>12}  {:>8}  {:>18}\n", "benchmark", nameWidth, "median", "min", "stddev", "throughput");
+		for (const Result& result : results) {
+			out << std::format("{:<{}}  {:>12}  {:>12}  {:>7.1f}%  {:>18}\n", result.name, nameWidth,
+				formatTime(result.median), formatTime(result.min), result.mean > 0 ? result.standardDeviation / result.mean * 100 : 0,
+				formatThroughput(result.getThroughput(), result.itemName));
+		}
+	}
+
+	void Runner::writeJson(std::ostream& out) const {
+		out << "{\n";
+		out << "\t\"context\": {\n";
+		out << std::format("\t\t\"compiler\": \"{}\",\n", escape(getCompiler()));
+#ifdef NDEBUG
+		out << "\t\t\"build\": \"release\",\n";
+#else
+		out << "\t\t\"build\": \"debug\",\n";
+#endif
+		out << std::format("\t\t\"threads\": {},\n", std::thread::hardware_concurrency());
+		out << std::format("\t\t\"warmup_ms\": {},\n", options.warmup.count());
+		out << std::format("\t\t\"min_sample_ms\": {},\n", options.minSampleTime.count());
+		out << std::format("\t\t\"repetitions\": {}\n", options.repetitions);
+		out << "\t},\n";
+
+		out << "\t\"benchmarks\": [";
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result& result = results[i];
+
+			out << (i == 0 ? "\n" : ",\n");
+			out << "\t\t{\n";
+			out << std::format("\t\t\t\"name\": \"{}\",\n", escape(result.name));
+			out << std::format("\t\t\t\"iterations\": {},\n", result.iterations);
+			out << std::format("\t\t\t\"items_per_iteration\": {},\n", result.itemsPerIteration);
+			out << std::format("\t\t\t\"item\": \"{}\",\n", escape(result.itemName));
+			out << std::format("\t\t\t\"min_ns\": {:.3f},\n", result.min);
+			out << std::format("\t\t\t\"max_ns\": {:.3f},\n", result.max);
+			out << std::format("\t\t\t\"mean_ns\": {:.3f},\n", result.mean);
+			out << std::format("\t\t\t\"median_ns\": {:.3f},\n", result.median);
+			out << std::format("\t\t\t\"stddev_ns\": {:.3f},\n", result.standardDeviation);
+			out << std::format("\t\t\t\"items_per_second\": {:.3f},\n", result.getThroughput());
+
+			out << "\t\t\t\"samples_ns\": [";
+			for (size_t sample = 0; sample < result.samples.size(); sample++)
+				out << std::format("{}{:.3f}", sample == 0 ? "" : ", ", result.samples[sample]);
+			out << "]\n";
+			out << "\t\t}";
+		}
+		out << "\n\t]\n";
+		out << "}\n";
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Minecraft::Bench {
+	/// times of a single benchmark, in nanoseconds per iteration
+	struct Result {
+		std::string name;
+		/// iterations that are timed together per sample, chosen so a sample takes at least 'Options::minSampleTime'
+		size_t iterations = 0;
+		/// amount of blocks, points, bytes, ... one iteration handles, used for the throughput
+		size_t itemsPerIteration = 1;
+		std::string itemName;
+
+		std::vector<double> samples;
+
+		double min = 0;
+		double max = 0;
+		double mean = 0;
+		double median = 0;
+		double standardDeviation = 0;
+
+		/// items per second, based on the median
+		double getThroughput() const;
+	};
+
+	struct Options {
+		/// only benchmarks with a name containing this are run
+		std::string filter;
+		std::chrono::milliseconds warmup = std::chrono::milliseconds(200);
+		std::chrono::milliseconds minSampleTime = std::chrono::milliseconds(20);
+		size_t repetitions = 15;
+	};
+
+	/// runs every benchmark for a while without timing it to warm up caches and clocks, then takes 'repetitions' samples
+	class Runner {
+	public:
+		Runner(Options options);
+
+		/// 'function' is a single iteration, use 'doNotOptimize' on its results so they aren't optimized away
+		void run(const std::string& name, size_t itemsPerIteration, const std::string& itemName, const std::function<void()>& function);
+
+		const std::vector<Result>& getResults() const;
+
+		/// a line per benchmark, for people
+		void writeTable(std::ostream& out) const;
+		/// every result and its samples, for comparing runs on ci
+		void writeJson(std::ostream& out) const;
+
+	private:
+		Options options;
+		std::vector<Result> results;
+	};
+
+	/// makes the compiler assume 'value' is read, without costing anything at runtime
+	template<typename T>
+	void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+}
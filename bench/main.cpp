@@ -0,0 +1,371 @@
+#include "benchmark.h"
+
+#include "block.h"
+#include "chunk.h"
+#include "compression.h"
+#include "frustum.h"
+#include "image.h"
+#include "lighting.h"
+#include "mesher.h"
+#include "noise.h"
+#include "qoi.h"
+#include "terrainGenerator.h"
+#include "visibility.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Minecraft;
+
+namespace {
+	constexpr uint32_t SEED = 1337;
+
+	struct Arguments {
+		Bench::Options options;
+		/// nothing when only the table should be printed
+		std::string json;
+	};
+
+	/// 'minecraft_bench [--filter name] [--repetitions 15] [--warmup 200] [--sample-time 20] [--json results.json]'
+	/// times are in milliseconds
+	Arguments parseArguments(int argc, char** argv) {
+		Arguments arguments;
+
+		for (int i = 1; i < argc; i++) {
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc && !std::string_view(argv[i + 1]).starts_with("--");
+			unsigned long long value = 0;
+
+			if (argument == "--filter" && hasValue) {
+				arguments.options.filter = argv[++i];
+			} else if (argument == "--json" && hasValue) {
+				arguments.json = argv[++i];
+			} else if ((argument == "--repetitions" || argument == "--warmup" || argument == "--sample-time") && hasValue) {
+				if (std::sscanf(argv[++i], "%llu", &value) != 1) {
+					std::cerr << argument << " should be followed by a number, not '" << argv[i] << "'" << std::endl;
+					continue;
+				}
+
+				if (argument == "--repetitions")
+					arguments.options.repetitions = value;
+				else if (argument == "--warmup")
+					arguments.options.warmup = std::chrono::milliseconds(value);
+				else
+					arguments.options.minSampleTime = std::chrono::milliseconds(value);
+			} else
+				std::cerr << "unknown argument '" << argument << "'" << std::endl;
+		}
+
+		return arguments;
+	}
+
+	std::shared_ptr<World::Chunk> generateChunk(const World::TerrainGenerator& generator, glm::ivec2 position) {
+		std::shared_ptr<World::Chunk> chunk = std::make_shared<World::Chunk>(position);
+		generator.generate(*chunk);
+		return chunk;
+	}
+
+	/// the highest section that isn't empty, which has the terrain surface and the most faces to mesh
+	int findSurfaceSection(const World::Chunk& chunk) {
+		int sectionY = World::Chunk::SECTION_COUNT - 1;
+		while (sectionY > 0 && !chunk.getSection(sectionY))
+			sectionY--;
+		return sectionY;
+	}
+
+	std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+
+	void benchmarkBlockAccess(Bench::Runner& runner, const World::Chunk& chunk) {
+		const World::ChunkSection& section = *chunk.getSection(findSurfaceSection(chunk));
+
+		runner.run("section/getBlock", World::ChunkSection::VOLUME, "blocks", [&section]() {
+			uint32_t sum = 0;
+			for (int i = 0; i < World::ChunkSection::VOLUME; i++)
+				sum += section.getBlock(i);
+			Bench::doNotOptimize(sum);
+		});
+
+		// every write goes through the palette, and the first writes of a new block repack the section
+		runner.run("section/setBlock", World::ChunkSection::VOLUME, "blocks", [&section]() {
+			World::ChunkSection copy;
+			for (int i = 0; i < World::ChunkSection::VOLUME; i++)
+				copy.setBlock(i, section.getBlock(i));
+			Bench::doNotOptimize(copy);
+		});
+
+		std::array<World::BlockId, World::ChunkSection::VOLUME> blocks;
+		for (int i = 0; i < World::ChunkSection::VOLUME; i++)
+			blocks[i] = section.getBlock(i);
+
+		runner.run("section/setBlocks", World::ChunkSection::VOLUME, "blocks", [&blocks]() {
+			World::ChunkSection copy;
+			copy.setBlocks(blocks);
+			Bench::doNotOptimize(copy);
+		});
+
+		runner.run("chunk/getBlock", World::Chunk::HEIGHT * World::ChunkSection::AREA, "blocks", [&chunk]() {
+			uint32_t sum = 0;
+			for (int y = 0; y < World::Chunk::HEIGHT; y++)
+				for (int z = 0; z < World::ChunkSection::SIZE; z++)
+					for (int x = 0; x < World::ChunkSection::SIZE; x++)
+						sum += chunk.getBlock(x, y, z);
+			Bench::doNotOptimize(sum);
+		});
+	}
+
+	void benchmarkNoise(Bench::Runner& runner) {
+		constexpr size_t POINT_COUNT = 4096;
+
+		World::Noise noise(SEED);
+		std::vector<float> x(POINT_COUNT);
+		std::vector<float> y(POINT_COUNT);
+		std::vector<float> z(POINT_COUNT);
+		std::vector<float> out(POINT_COUNT);
+		// a 16x16x16 lattice, like the generator samples
+		for (size_t i = 0; i < POINT_COUNT; i++) {
+			x[i] = (i % 16) / 48.0f;
+			y[i] = (i / 256) / 48.0f;
+			z[i] = ((i / 16) % 16) / 48.0f;
+		}
+
+		runner.run("noise/sample", POINT_COUNT, "points", [&]() {
+			for (size_t i = 0; i < POINT_COUNT; i++)
+				out[i] = noise.sample(x[i], y[i], z[i]);
+			Bench::doNotOptimize(out.data());
+		});
+
+		runner.run("noise/sample batched", POINT_COUNT, "points", [&]() {
+			noise.sample(x.data(), y.data(), z.data(), out.data(), POINT_COUNT);
+			Bench::doNotOptimize(out.data());
+		});
+	}
+
+	void benchmarkTerrain(Bench::Runner& runner, const World::TerrainGenerator& generator) {
+		// a different chunk every iteration, so nothing of the previous one is in the cache
+		int index = 0;
+		runner.run("terrain/generate", 1, "chunks", [&generator, &index]() {
+			index++;
+			Bench::doNotOptimize(generateChunk(generator, { index % 64, index / 64 }));
+		});
+
+		runner.run("terrain/heightmap", World::ChunkSection::AREA, "columns", [&generator, &index]() {
+			index++;
+			Bench::doNotOptimize(generator.generateHeightmap({ index % 64, index / 64 }));
+		});
+	}
+
+	void benchmarkMeshing(Bench::Runner& runner, const std::array<std::shared_ptr<World::Chunk>, 9>& chunks) {
+		// chunks are a 3x3 grid, 4 is the one in the middle
+		const World::Chunk& chunk = *chunks[4];
+		int sectionY = findSurfaceSection(chunk);
+		const World::ChunkSection& section = *chunk.getSection(sectionY);
+		World::Mesher::Neighbours neighbours = {
+			chunks[3]->getSection(sectionY),
+			chunks[5]->getSection(sectionY),
+			chunk.getSection(sectionY - 1),
+			chunk.getSection(sectionY + 1),
+			chunks[1]->getSection(sectionY),
+			chunks[7]->getSection(sectionY),
+		};
+		World::MeshLight light = {
+			chunk.getLight(sectionY),
+			{
+				chunks[3]->getLight(sectionY),
+				chunks[5]->getLight(sectionY),
+				chunk.getLight(sectionY - 1),
+				chunk.getLight(sectionY + 1),
+				chunks[1]->getLight(sectionY),
+				chunks[7]->getLight(sectionY),
+			},
+		};
+
+		runner.run("mesher/greedy", World::ChunkSection::VOLUME, "blocks", [&section, &neighbours, &light]() {
+			Bench::doNotOptimize(World::Mesher::mesh(section, neighbours, true, light));
+		});
+
+		runner.run("mesher/per face", World::ChunkSection::VOLUME, "blocks", [&section, &neighbours, &light]() {
+			Bench::doNotOptimize(World::Mesher::mesh(section, neighbours, false, light));
+		});
+
+		runner.run("visibility/compute", World::ChunkSection::VOLUME, "blocks", [&section]() {
+			Bench::doNotOptimize(World::Visibility::compute(section));
+		});
+	}
+
+	void benchmarkCulling(Bench::Runner& runner, const World::TerrainGenerator& generator) {
+		constexpr int RADIUS = 8;
+
+		glm::vec3 camera(0.5f, World::TerrainGenerator::BASE_HEIGHT + 8.5f, 0.5f);
+		glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16 / 9.0f, 0.1f, 1000.0f);
+		glm::mat4 view = glm::lookAt(camera, camera + glm::vec3(1, -0.2f, 0.3f), glm::vec3(0, 1, 0));
+		Render::Frustum frustum(projection * view);
+
+		// every section within the radius, like the renderer tests them
+		std::vector<Render::AABB> boxes;
+		World::VisibilityGraph graph;
+		for (int chunkZ = -RADIUS; chunkZ < RADIUS; chunkZ++) {
+			for (int chunkX = -RADIUS; chunkX < RADIUS; chunkX++) {
+				std::shared_ptr<World::Chunk> chunk = generateChunk(generator, { chunkX, chunkZ });
+				for (int sectionY = 0; sectionY < World::Chunk::SECTION_COUNT; sectionY++) {
+					glm::ivec3 position(chunkX, sectionY, chunkZ);
+					glm::vec3 origin(position * World::ChunkSection::SIZE);
+					boxes.push_back({ origin, origin + glm::vec3(World::ChunkSection::SIZE) });
+
+					const World::ChunkSection* section = chunk->getSection(sectionY);
+					graph.set(position, section ? World::Visibility::compute(*section) : World::Visibility());
+				}
+			}
+		}
+
+		std::vector<uint8_t> visible(boxes.size());
+
+		runner.run("frustum/isVisible", boxes.size(), "boxes", [&]() {
+			for (size_t i = 0; i < boxes.size(); i++)
+				visible[i] = frustum.isVisible(boxes[i]);
+			Bench::doNotOptimize(visible.data());
+		});
+
+		runner.run("frustum/cull", boxes.size(), "boxes", [&]() {
+			Bench::doNotOptimize(frustum.cull(boxes, visible));
+		});
+
+		glm::ivec3 start = glm::ivec3(glm::floor(camera)) / World::ChunkSection::SIZE;
+		runner.run("visibility/findVisible", boxes.size(), "sections", [&]() {
+			Bench::doNotOptimize(graph.findVisible(start, &frustum).size());
+		});
+	}
+
+	void benchmarkImages(Bench::Runner& runner) {
+		// relative to the working directory, like the game loads its assets
+		std::filesystem::path path = "assets/textures/blocks.png";
+		std::vector<uint8_t> png = readFile(path);
+		std::shared_ptr<Assets::Image> image = Assets::Image::decode(png);
+		if (!image) {
+			std::cerr << "could not load '" << path.string() << "', skipping the image benchmarks" << std::endl;
+			return;
+		}
+
+		size_t pixelCount = size_t(image->getSize().x) * image->getSize().y;
+		std::vector<uint8_t> qoi = Assets::Qoi::encode(*image);
+
+		runner.run("image/decode png", pixelCount, "pixels", [&png]() {
+			Bench::doNotOptimize(Assets::Image::decode(png));
+		});
+
+		runner.run("image/decode qoi", pixelCount, "pixels", [&qoi]() {
+			Bench::doNotOptimize(Assets::Image::decode(qoi));
+		});
+
+		runner.run("image/encode qoi", pixelCount, "pixels", [&image]() {
+			Bench::doNotOptimize(Assets::Qoi::encode(*image));
+		});
+
+		runner.run("image/mipChain", pixelCount, "pixels", [&image]() {
+			Bench::doNotOptimize(image->mipChain());
+		});
+	}
+
+	void benchmarkLighting(Bench::Runner& runner, const World::TerrainGenerator& generator, const std::array<std::shared_ptr<World::Chunk>, 9>& chunks) {
+		// light isn't serialized, so every iteration starts from a chunk without any, 'chunk/deserialize' is the part that isn't lighting
+		std::vector<uint8_t> serialized = chunks[4]->serialize();
+		runner.run("lighting/chunk", 1, "chunks", [&serialized]() {
+			std::shared_ptr<World::Chunk> chunk = World::Chunk::deserialize({ 0, 0 }, serialized);
+			World::Lighting::lightChunk(*chunk);
+			Bench::doNotOptimize(chunk);
+		});
+
+		// the chunks are in the order of the region already
+		World::LightRegion region({ 0, 0 }, chunks);
+
+		// glowstone a few blocks above the surface, placed and removed again, which are two updates
+		std::array<int, World::ChunkSection::AREA> heightmap = generator.generateHeightmap({ 0, 0 });
+		World::BlockId glowstone = World::BlockRegistry::find("glowstone");
+		int index = 0;
+		runner.run("lighting/update", 2, "updates", [&]() {
+			index = (index + 7) % World::ChunkSection::AREA;
+			glm::ivec3 position(index % World::ChunkSection::SIZE, heightmap[index] + 3, index / World::ChunkSection::SIZE);
+
+			World::BlockId replaced = region.getBlock(region.toLocal(position));
+			Bench::doNotOptimize(World::Lighting::setBlock(region, position, glowstone));
+			Bench::doNotOptimize(World::Lighting::setBlock(region, position, replaced));
+		});
+	}
+
+	void benchmarkCompression(Bench::Runner& runner, const World::Chunk& chunk) {
+		std::vector<uint8_t> serialized = chunk.serialize();
+		std::vector<uint8_t> compressed = IO::Compression::compress(serialized);
+		std::vector<uint8_t> decompressed(serialized.size());
+
+		runner.run("chunk/serialize", 1, "chunks", [&chunk]() {
+			Bench::doNotOptimize(chunk.serialize());
+		});
+
+		runner.run("chunk/deserialize", 1, "chunks", [&serialized]() {
+			Bench::doNotOptimize(World::Chunk::deserialize({ 0, 0 }, serialized));
+		});
+
+		runner.run("compression/compress", serialized.size(), "B", [&serialized]() {
+			Bench::doNotOptimize(IO::Compression::compress(serialized));
+		});
+
+		runner.run("compression/decompress", serialized.size(), "B", [&compressed, &decompressed]() {
+			Bench::doNotOptimize(IO::Compression::decompress(compressed, decompressed));
+		});
+	}
+}
+
+/// benchmarks of the hot paths that only use the cpu, so it runs without a gpu or a window
+int main(int argc, char** argv) {
+	Arguments arguments = parseArguments(argc, argv);
+
+	World::BlockRegistry::registerDefaults();
+	World::TerrainGenerator generator(SEED);
+
+	std::array<std::shared_ptr<World::Chunk>, 9> chunks;
+	for (int i = 0; i < 9; i++)
+		chunks[i] = generateChunk(generator, { i % 3 - 1, i / 3 - 1 });
+
+	// lit like the chunk loader does, so meshing sees real light
+	for (const std::shared_ptr<World::Chunk>& chunk : chunks)
+		World::Lighting::lightChunk(*chunk);
+	World::LightRegion region({ 0, 0 }, chunks);
+	World::Lighting::spreadBorders(region);
+
+	Bench::Runner runner(arguments.options);
+
+	benchmarkBlockAccess(runner, *chunks[4]);
+	benchmarkNoise(runner);
+	benchmarkTerrain(runner, generator);
+	benchmarkMeshing(runner, chunks);
+	benchmarkCulling(runner, generator);
+	benchmarkImages(runner);
+	benchmarkCompression(runner, *chunks[4]);
+	benchmarkLighting(runner, generator, chunks);
+
+	runner.writeTable(std::cout);
+
+	if (!arguments.json.empty()) {
+		std::ofstream json(arguments.json);
+		if (!json) {
+			std::cerr << "could not open '" << arguments.json << "' to write the results to" << std::endl;
+			return 1;
+		}
+		runner.writeJson(json);
+	}
+
+	return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Minecraft::IO {
+	/// little endian integer encoding for anything written to disk, independent of the host byte order
+
+	template<std::unsigned_integral T>
+	void writeLittleEndian(std::vector<uint8_t>& out, T value) {
+		for (size_t i = 0; i < sizeof(T); i++)
+			out.push_back(uint8_t(value >> (i * 8)));
+	}
+
+	template<std::unsigned_integral T>
+	void writeLittleEndian(std::span<uint8_t> out, size_t offset, T value) {
+		for (size_t i = 0; i < sizeof(T); i++)
+			out[offset + i] = uint8_t(value >> (i * 8));
+	}
+
+	/// the caller checks that 'offset + sizeof(T)' is within 'data'
+	template<std::unsigned_integral T>
+	T readLittleEndian(std::span<const uint8_t> data, size_t offset) {
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+			value |= T(data[offset + i]) << (i * 8);
+		return value;
+	}
+
+	/// 32 bit FNV-1a, to detect payloads that were only partially written
+	constexpr uint32_t checksum(std::span<const uint8_t> data) {
+		uint32_t hash = 2166136261u;
+		for (uint8_t byte : data)
+			hash = (hash ^ byte) * 16777619u;
+		return hash;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "chunk.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Minecraft::World {
+	enum class Face : uint8_t {
+		NEG_X, POS_X,
+		NEG_Y, POS_Y,
+		NEG_Z, POS_Z,
+	};
+
+	constexpr int FACE_COUNT = 6;
+
+	constexpr int faceAxis(Face face) { return static_cast<int>(face) / 2; }
+	constexpr int faceSign(Face face) { return static_cast<int>(face) % 2 == 0 ? -1 : 1; }
+	constexpr Face opposite(Face face) { return static_cast<Face>(static_cast<int>(face) ^ 1); }
+	constexpr glm::ivec3 faceNormal(Face face) {
+		int axis = faceAxis(face);
+		int sign = faceSign(face);
+		return { axis == 0 ? sign : 0, axis == 1 ? sign : 0, axis == 2 ? sign : 0 };
+	}
+
+	struct Block {
+		std::string name;
+		/// opaque blocks hide the faces of the blocks next to them
+		bool isOpaque = true;
+		/// layer of the block texture array per face, in the order of 'Face'
+		std::array<uint16_t, FACE_COUNT> textures = {};
+		/// block light the block gives off, from 0 to 'SectionLight::MAX'
+		uint8_t light = 0;
+	};
+
+	/// global list of known blocks, the index in the registry is the block id
+	/// blocks are registered at startup, after that the registry is only read, so it's safe to use from any thread
+	class BlockRegistry {
+	public:
+		static BlockId add(const Block& block);
+		static BlockId find(const std::string& name);
+
+		static const Block& get(BlockId id);
+		static bool isOpaque(BlockId id);
+		static uint8_t getLight(BlockId id);
+		static size_t size();
+
+		static void registerDefaults();
+
+	private:
+		static std::vector<Block>& blocks();
+		static std::vector<bool>& opaque();
+		static std::vector<uint8_t>& light();
+	};
+}
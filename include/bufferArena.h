@@ -0,0 +1,93 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Minecraft::Render {
+	struct ArenaStats {
+		size_t capacity = 0;
+		size_t used = 0;
+		size_t allocationCount = 0;
+		size_t freeRangeCount = 0;
+		size_t largestFreeRange = 0;
+		/// 0 when all free space is one range, approaching 1 as it's split into smaller ranges
+		float fragmentation = 0;
+		/// used divided by capacity
+		float occupancy = 0;
+		uint64_t growCount = 0;
+		uint64_t defragmentCount = 0;
+		uint64_t bytesMoved = 0;
+	};
+
+	/// sub-allocates ranges of one large immutable buffer, so many small meshes don't each need their own buffer object
+	/// free ranges are kept in a first fit free list, and merged with their neighbours when freed
+	/// ranges are referred to by handle, as growing or defragmenting the arena moves them, and can replace the buffer
+	class BufferArena {
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle INVALID_HANDLE = 0;
+
+		/// 'alignment' applies to both the offsets and the sizes of allocations, in bytes
+		BufferArena(size_t capacity, size_t alignment = 4);
+
+		BufferArena(const BufferArena&) = delete;
+		BufferArena& operator=(const BufferArena&) = delete;
+		~BufferArena();
+
+		/// grows the buffer when there is no free range large enough
+		[[nodiscard]] Handle allocate(size_t size);
+		void free(Handle handle);
+		/// copies 'size' bytes to the start of the range
+		void write(Handle handle, const void* data, size_t size);
+		/// copies 'size' bytes from another buffer to the start of the range, without the data passing through the cpu
+		void copy(Handle handle, GLuint source, size_t sourceOffset, size_t size);
+
+		/// offset of the range in bytes, changes when the arena is defragmented
+		size_t getOffset(Handle handle) const;
+		size_t getSize(Handle handle) const;
+		/// changes when the arena grows or is defragmented
+		GLuint getBuffer() const;
+
+		/// moves every range to the start of a new buffer, so the free space becomes one range at the end
+		/// returns the amount of bytes that were copied
+		size_t defragment();
+		/// defragments when the fragmentation is above 'threshold', and there is enough free space for it to matter
+		bool defragmentIfNeeded(float threshold = 0.5f);
+
+		ArenaStats getStats() const;
+
+	private:
+		struct Allocation {
+			size_t offset = 0;
+			size_t size = 0;
+			bool isUsed = false;
+		};
+
+		bool allocateRange(size_t size, size_t& offset);
+		void freeRange(size_t offset, size_t size);
+		/// immutable storage can't be resized, so the contents are copied to a new buffer
+		void grow(size_t capacity);
+
+		float getFragmentation() const;
+
+		GLuint buffer = 0;
+		size_t capacity = 0;
+		size_t alignment = 0;
+		size_t used = 0;
+
+		/// offset -> size
+		std::map<size_t, size_t> freeRanges = {};
+
+		/// indexed by handle, handle 0 is never used
+		std::vector<Allocation> allocations = { {} };
+		std::vector<Handle> freeHandles = {};
+
+		uint64_t growCount = 0;
+		uint64_t defragmentCount = 0;
+		uint64_t bytesMoved = 0;
+	};
+}
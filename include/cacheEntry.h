@@ -0,0 +1,38 @@
+#pragma once
+
+#include "mappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace Minecraft::IO {
+	/// file of an on-disk cache, with metadata of the cache, the key it was stored under and a checksummed payload
+	/// entries are named after a hash of their key, the key itself is kept to tell apart keys with the same hash
+	/// safe to use from multiple threads, also when they read and write the same entry
+	class CacheEntry {
+	public:
+		/// the file of 'key' in 'directory'
+		static std::filesystem::path getPath(const std::filesystem::path& directory, std::string_view key, std::string_view extension);
+
+		/// nullptr if there is no entry, it has another 'magic' or 'version', belongs to another key or failed its checksum
+		/// 'magic' is 4 characters
+		[[nodiscard]] static std::shared_ptr<CacheEntry> read(const std::filesystem::path& path, std::string_view magic, uint8_t version, std::string_view key);
+		/// written next to the entry and moved over it, so a reader never sees half an entry
+		static bool write(const std::filesystem::path& path, std::string_view magic, uint8_t version, std::string_view key,
+			std::span<const uint8_t> metadata, std::span<const uint8_t> payload);
+
+		/// valid for as long as the entry is
+		std::span<const uint8_t> getMetadata() const;
+		std::span<const uint8_t> getPayload() const;
+
+	private:
+		CacheEntry() = default;
+
+		std::shared_ptr<MappedFile> file = nullptr;
+		std::span<const uint8_t> metadata = {};
+		std::span<const uint8_t> payload = {};
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace Minecraft::Assets {
+	/// uniform buffer binding of the 'Camera' block, linking a program binds its block here
+	constexpr GLuint CAMERA_BINDING = 1;
+
+	/// std140 layout of the 'Camera' block
+	struct CameraUniforms {
+		glm::mat4 viewMatrix = glm::mat4(1);
+		glm::mat4 projectionMatrix = glm::mat4(1);
+		glm::mat4 viewProjectionMatrix = glm::mat4(1);
+		/// w is unused, a vec3 would be padded to 16 bytes anyway
+		glm::vec4 cameraPosition = glm::vec4(0, 0, 0, 1);
+	};
+	static_assert(sizeof(CameraUniforms) == 3 * 64 + 16, "CameraUniforms has to match the std140 layout");
+
+	/// uniform buffer with the view and projection, shared by every program instead of setting them on each one
+	class CameraBuffer {
+	public:
+		CameraBuffer();
+
+		CameraBuffer(const CameraBuffer&) = delete;
+		CameraBuffer& operator=(const CameraBuffer&) = delete;
+		~CameraBuffer();
+
+		/// only uploads when something changed
+		void update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position);
+		/// binds the buffer to CAMERA_BINDING, which is done on creation already
+		void bind() const;
+
+		const CameraUniforms& getUniforms() const;
+
+	private:
+		GLuint buffer = 0;
+
+		CameraUniforms uniforms = {};
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace Minecraft::Assets {
+	/// camera positions over time, linearly interpolated between keyframes
+	/// the file has a keyframe per line, 'time x y z yaw pitch', with the time in seconds and the angles in degrees
+	/// a yaw and pitch of 0 look along -z, a positive yaw turns left and a positive pitch looks up
+	/// empty lines and lines starting with '#' are skipped
+	class CameraPath {
+	public:
+		struct Keyframe {
+			float time = 0;
+			glm::vec3 position = { 0, 0, 0 };
+			/// yaw and pitch, in radians
+			glm::vec2 rotation = { 0, 0 };
+		};
+
+		/// returns nullptr if the file can't be read or has no keyframes
+		[[nodiscard]] static std::shared_ptr<CameraPath> load(const std::filesystem::path& path);
+
+		/// clamped to the first and last keyframe
+		Keyframe sample(float time) const;
+		/// view matrix of 'sample(time)'
+		glm::mat4 getView(float time) const;
+
+		/// time of the last keyframe
+		float getDuration() const;
+
+	private:
+		CameraPath() = default;
+
+		/// sorted by time
+		std::vector<Keyframe> keyframes = {};
+	};
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Minecraft::World {
+	using BlockId = uint16_t;
+
+	constexpr BlockId AIR = 0;
+
+	struct ChunkPositionHash {
+		size_t operator()(glm::ivec2 position) const {
+			return std::hash<uint64_t>()(uint64_t(uint32_t(position.x)) << 32 | uint32_t(position.y));
+		}
+	};
+
+	struct SectionPositionHash {
+		size_t operator()(glm::ivec3 position) const {
+			return ChunkPositionHash()({ position.x, position.z }) * 31 + std::hash<int>()(position.y);
+		}
+	};
+
+	/// 16x16x16 cube of blocks, stored as indices into a palette of block ids
+	/// the indices are bit-packed with a power of two width, so entries never straddle two words
+	/// and lookups are a shift and a mask
+	class ChunkSection {
+	public:
+		static constexpr int SIZE = 16;
+		static constexpr int AREA = SIZE * SIZE;
+		static constexpr int VOLUME = SIZE * SIZE * SIZE;
+
+		ChunkSection(BlockId fill = AIR);
+
+		ChunkSection(const ChunkSection&) = default;
+		ChunkSection(ChunkSection&&) noexcept = default;
+		ChunkSection& operator=(const ChunkSection&) = default;
+		ChunkSection& operator=(ChunkSection&&) noexcept = default;
+		~ChunkSection() = default;
+
+		BlockId getBlock(int x, int y, int z) const { return getBlock(index(x, y, z)); }
+		BlockId getBlock(glm::ivec3 pos) const { return getBlock(index(pos.x, pos.y, pos.z)); }
+		BlockId getBlock(int index) const;
+
+		/// returns the block that was replaced
+		BlockId setBlock(int x, int y, int z, BlockId block) { return setBlock(index(x, y, z), block); }
+		BlockId setBlock(glm::ivec3 pos, BlockId block) { return setBlock(index(pos.x, pos.y, pos.z), block); }
+		BlockId setBlock(int index, BlockId block);
+
+		void fill(BlockId block);
+		/// replaces every block at once, which is a lot cheaper than setting them one by one
+		/// 'blocks' is in the order of 'index'
+		void setBlocks(std::span<const BlockId, VOLUME> blocks);
+
+		bool isUniform() const;
+		bool isEmpty() const;
+
+		/// number of distinct blocks currently in the section
+		size_t getPaletteSize() const;
+		uint8_t getBitsPerEntry() const;
+		/// heap and inline bytes used by this section
+		size_t getMemoryUsage() const;
+
+		static constexpr int index(int x, int y, int z) { return (y * SIZE + z) * SIZE + x; }
+		static constexpr glm::ivec3 position(int index) { return { index % SIZE, index / AREA, (index / SIZE) % SIZE }; }
+
+	private:
+		uint32_t getEntry(int index) const;
+		void setEntry(int index, uint32_t entry);
+
+		uint32_t findOrAddPaletteEntry(BlockId block);
+		void repack(uint8_t bits);
+
+		static uint8_t bitsFor(size_t paletteSize);
+
+		/// palette index -> block id, unused slots are kept in 'freeEntries' so indices stay valid
+		std::vector<BlockId> palette = {};
+		/// amount of blocks in the section referring to each palette entry
+		std::vector<uint16_t> counts = {};
+		std::vector<uint32_t> freeEntries = {};
+
+		std::vector<uint64_t> data = {};
+		/// one of 0, 1, 2, 4, 8 or 16, 0 means the section is uniform and 'data' is empty
+		uint8_t bitsPerEntry = 0;
+	};
+
+	enum class LightType : uint8_t {
+		/// emitted by blocks, fading by 1 per block
+		BLOCK,
+		/// coming from above, going straight down without fading and fading by 1 per block in other directions
+		SKY,
+	};
+
+	/// block light and sky light of a section, 4 bits per block each, indexed like 'ChunkSection::index'
+	class SectionLight {
+	public:
+		static constexpr uint8_t MAX = 15;
+
+		/// the light of sections that don't have any, no block light and full sky light
+		static constexpr uint8_t defaultLevel(LightType type) { return type == LightType::SKY ? MAX : 0; }
+
+		/// no block light, and 'skyLevel' sky light everywhere
+		SectionLight(uint8_t skyLevel = defaultLevel(LightType::SKY));
+
+		/// shared by every section the sky doesn't reach, which is most of them underground
+		static const SectionLight& dark();
+
+		uint8_t get(LightType type, int index) const {
+			return (levels(type)[index >> 1] >> ((index & 1) * 4)) & 0xF;
+		}
+		void set(LightType type, int index, uint8_t level) {
+			uint8_t& pair = levels(type)[index >> 1];
+			int shift = (index & 1) * 4;
+			pair = uint8_t((pair & ~(0xF << shift)) | (level & 0xF) << shift);
+		}
+
+		/// no block light and 'skyLevel' sky light everywhere, which sections of a chunk store without allocating
+		bool isUniform(uint8_t skyLevel) const;
+
+	private:
+		using Levels = std::array<uint8_t, ChunkSection::VOLUME / 2>;
+
+		Levels& levels(LightType type) { return type == LightType::SKY ? sky : block; }
+		const Levels& levels(LightType type) const { return type == LightType::SKY ? sky : block; }
+
+		Levels block;
+		Levels sky;
+	};
+
+	/// vertical column of sections, sections that only contain air are not allocated
+	/// light is kept apart from the blocks, as sections of air can still have light that differs from open sky
+	class Chunk {
+	public:
+		static constexpr int SECTION_COUNT = 16;
+		static constexpr int HEIGHT = SECTION_COUNT * ChunkSection::SIZE;
+
+		Chunk(glm::ivec2 position);
+
+		Chunk(const Chunk&) = delete;
+		Chunk(Chunk&&) noexcept = default;
+		Chunk& operator=(const Chunk&) = delete;
+		Chunk& operator=(Chunk&&) noexcept = default;
+		~Chunk() = default;
+
+		BlockId getBlock(int x, int y, int z) const;
+		BlockId getBlock(glm::ivec3 pos) const { return getBlock(pos.x, pos.y, pos.z); }
+		BlockId setBlock(int x, int y, int z, BlockId block);
+		BlockId setBlock(glm::ivec3 pos, BlockId block) { return setBlock(pos.x, pos.y, pos.z, block); }
+
+		/// nullptr if the section is entirely air
+		ChunkSection* getSection(int sectionY);
+		const ChunkSection* getSection(int sectionY) const;
+		ChunkSection& getOrCreateSection(int sectionY);
+		/// frees sections that only contain air
+		void trim();
+
+		/// nullptr if the section has the default light, see 'SectionLight::defaultLevel', 'SectionLight::dark' if it's dark
+		const SectionLight* getLight(int sectionY) const;
+		/// 'SectionLight::defaultLevel' above and below the chunk
+		uint8_t getLight(LightType type, int x, int y, int z) const;
+		void setLight(LightType type, int x, int y, int z, uint8_t level);
+		/// no block light and no sky light in the whole section, without allocating anything
+		void darken(int sectionY);
+		/// frees the light of sections that only have the default light, or no light at all
+		void trimLight();
+
+		glm::ivec2 getPosition() const;
+		size_t getMemoryUsage() const;
+
+		/// set by 'setBlock', cleared once the chunk is saved
+		bool isModified() const;
+		void setModified(bool modified);
+
+		/// the blocks of every section, uncompressed, in the format read by 'deserialize'
+		std::vector<uint8_t> serialize() const;
+		/// size of 'serialize' when every section has a palette entry for each of its blocks
+		static constexpr size_t MAX_SERIALIZED_SIZE = 3 + SECTION_COUNT * (2 + ChunkSection::VOLUME * 2 * 2);
+		/// nullptr if 'data' isn't a serialized chunk
+		[[nodiscard]] static std::shared_ptr<Chunk> deserialize(glm::ivec2 position, std::span<const uint8_t> data);
+
+	private:
+		glm::ivec2 position = { 0, 0 };
+		bool modified = false;
+
+		std::array<std::unique_ptr<ChunkSection>, SECTION_COUNT> sections = {};
+		/// not saved, it's computed again when the chunk is loaded
+		std::array<std::unique_ptr<SectionLight>, SECTION_COUNT> light = {};
+		/// sections without light of their own that are dark instead of having the default light
+		std::array<bool, SECTION_COUNT> dark = {};
+	};
+}
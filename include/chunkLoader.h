@@ -0,0 +1,129 @@
+#pragma once
+
+#include "world.h"
+#include "mesher.h"
+#include "lighting.h"
+#include "jobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Minecraft::World {
+	/// keeps the chunks around a position loaded and meshed, using the job system for the heavy lifting
+	/// chunks are read from the world's storage, and only generated when they were never saved
+	/// modified chunks are saved when they're unloaded, and when the loader is destroyed
+	/// chunks are lit on their own when they're generated, and their light is spread to their neighbours once those are loaded
+	/// lighting jobs lock the 3x3 chunks around their chunk, so jobs of regions that don't overlap run at the same time
+	/// everything besides the jobs themselves happens on the main thread, including the callbacks
+	class ChunkLoader {
+	public:
+		using MeshCallback = std::function<void(glm::ivec3 sectionPosition, ChunkMesh&& mesh)>;
+		using UnloadCallback = std::function<void(glm::ivec2 chunkPosition)>;
+
+		ChunkLoader(World& world, Jobs::JobSystem& jobs, int viewDistance);
+
+		ChunkLoader(const ChunkLoader&) = delete;
+		ChunkLoader& operator=(const ChunkLoader&) = delete;
+		/// cancels the jobs that are still running, and saves every modified chunk before returning
+		~ChunkLoader();
+
+		/// called for every section of a chunk once it's meshed, the mesh can be empty
+		void onMeshed(MeshCallback callback);
+		/// called when a chunk that was meshed is unloaded
+		void onUnloaded(UnloadCallback callback);
+
+		/// loads chunks within the view distance of 'center' and unloads the ones that have left it
+		void update(glm::ivec2 center);
+
+		/// changes a block once its chunk is lit, then updates the light and the meshes around it
+		/// returns false if the chunk isn't loaded, changes to chunks that are unloaded before they're applied are dropped
+		bool setBlock(glm::ivec3 position, BlockId block);
+
+		void setViewDistance(int viewDistance);
+		int getViewDistance() const;
+
+		size_t getGeneratingCount() const;
+		size_t getMeshingCount() const;
+		size_t getMeshedCount() const;
+		size_t getLightingCount() const;
+		/// block changes that updated the light, and the time spent on them by the workers
+		uint64_t getLightUpdateCount() const;
+		std::chrono::nanoseconds getLightUpdateTime() const;
+		uint64_t getCancelledCount() const;
+		/// chunks that are still being written to disk
+		size_t getSavingCount() const;
+		uint64_t getLoadedCount() const;
+		uint64_t getSavedCount() const;
+
+	private:
+		enum class State {
+			/// loading from disk or generating
+			GENERATING,
+			GENERATED,
+			MESHING,
+			MESHED,
+		};
+
+		struct Entry {
+			State state = State::GENERATING;
+			Jobs::JobHandle job = {};
+			/// results of jobs for an older entry at the same position are ignored
+			uint64_t ticket = 0;
+			/// the light has been spread across the borders with all four neighbours, chunks are only meshed after that
+			bool isLit = false;
+			/// meshes have been handed to the callback, they stay until the chunk is unloaded, even while meshing again
+			bool hasMesh = false;
+			/// block changes waiting for a lighting job, in world coordinates
+			std::vector<std::pair<glm::ivec3, BlockId>> pendingBlocks = {};
+		};
+
+		void generate(glm::ivec2 position, Jobs::Priority priority);
+		bool canLight(glm::ivec2 position) const;
+		void light(glm::ivec2 position, Entry& entry);
+		bool canMesh(glm::ivec2 position) const;
+		void mesh(glm::ivec2 position, Entry& entry);
+		/// ends the reads of a meshing job of the chunk at 'position'
+		void releaseReaders(glm::ivec2 position);
+		void save(std::shared_ptr<Chunk> chunk);
+
+		bool isInRange(glm::ivec2 position, int distance) const;
+
+		World& world;
+		Jobs::JobSystem& jobs;
+
+		int viewDistance = 0;
+		glm::ivec2 center = { 0, 0 };
+
+		std::unordered_map<glm::ivec2, Entry, ChunkPositionHash> entries = {};
+		uint64_t nextTicket = 0;
+		uint64_t cancelledCount = 0;
+
+		/// chunks written by a lighting job, nothing else reads or writes them until it's done
+		std::unordered_set<glm::ivec2, ChunkPositionHash> locked = {};
+		/// amount of meshing jobs reading each chunk, these can't be locked
+		std::unordered_map<glm::ivec2, int, ChunkPositionHash> readers = {};
+		size_t lightingCount = 0;
+		std::atomic<uint64_t> lightUpdateCount = 0;
+		std::atomic<int64_t> lightUpdateNanoseconds = 0;
+
+		/// unloaded chunks with a save in flight, reused when they come back in range before the save finishes
+		std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>, ChunkPositionHash> saving = {};
+		std::atomic<uint64_t> loadedCount = 0;
+		std::atomic<uint64_t> savedCount = 0;
+
+		MeshCallback meshCallback = nullptr;
+		UnloadCallback unloadCallback = nullptr;
+
+		/// checked by main thread jobs, as they can outlive the loader
+		std::shared_ptr<bool> isAlive = std::make_shared<bool>(true);
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "chunk.h"
+#include "mesher.h"
+#include "bufferArena.h"
+#include "streamBuffer.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Minecraft::Render {
+	/// draws every chunk section with a single 'glMultiDrawElementsIndirect'
+	/// all meshes share one vertex and one index buffer arena, the section origin of each draw is read from a storage buffer with 'gl_DrawID'
+	/// the shader is expected to declare 'layout(std430, binding = 0) readonly buffer Sections { ivec4 origins[]; }'
+	/// meshes, draw commands and origins are staged in the stream buffer, and only written directly when it's full
+	class ChunkRenderer {
+	public:
+		/// initial capacities in bytes, the buffers grow when needed
+		ChunkRenderer(StreamBuffer& stream, size_t vertexCapacity = 8 << 20, size_t indexCapacity = 6 << 20);
+
+		ChunkRenderer(const ChunkRenderer&) = delete;
+		ChunkRenderer& operator=(const ChunkRenderer&) = delete;
+		~ChunkRenderer();
+
+		/// replaces the mesh of the section, an empty mesh removes it
+		void upload(glm::ivec3 sectionPosition, const World::ChunkMesh& mesh);
+		void remove(glm::ivec3 sectionPosition);
+		bool contains(glm::ivec3 sectionPosition) const;
+
+		/// draws the given sections with the currently bound program, sections without a mesh are skipped
+		void draw(std::span<const glm::ivec3> sectionPositions);
+
+		size_t getSectionCount() const;
+		/// draws submitted by the last call to 'draw', all of them in one call
+		size_t getDrawCount() const;
+		ArenaStats getVertexStats() const;
+		ArenaStats getIndexStats() const;
+
+	private:
+		/// matches the layout 'glMultiDrawElementsIndirect' reads
+		struct DrawCommand {
+			GLuint count;
+			GLuint instanceCount;
+			GLuint firstIndex;
+			GLint baseVertex;
+			GLuint baseInstance;
+		};
+
+		struct Section {
+			BufferArena::Handle vertices = BufferArena::INVALID_HANDLE;
+			BufferArena::Handle indices = BufferArena::INVALID_HANDLE;
+			GLuint indexCount = 0;
+		};
+
+		/// points the vertex array at the arena buffers, which change when the arenas grow or are defragmented
+		void bindBuffers();
+		void write(BufferArena& arena, BufferArena::Handle handle, const void* data, size_t size);
+
+		StreamBuffer& stream;
+		size_t storageAlignment = 0;
+
+		GLuint vao = 0;
+		GLuint boundVertexBuffer = 0;
+		GLuint boundIndexBuffer = 0;
+		GLuint commandBuffer = 0;
+		GLuint originBuffer = 0;
+		/// used when the stream buffer is full, in draws, the command and origin buffers are grown together
+		size_t drawCapacity = 0;
+
+		BufferArena vertices;
+		BufferArena indices;
+
+		std::unordered_map<glm::ivec3, Section, World::SectionPositionHash> sections = {};
+
+		std::vector<DrawCommand> commands = {};
+		std::vector<glm::ivec4> origins = {};
+	};
+}
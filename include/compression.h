@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Minecraft::IO {
+	/// byte compression in the LZ4 block format, fast enough to run on every chunk load and save
+	class Compression {
+	public:
+		[[nodiscard]] static std::vector<uint8_t> compress(std::span<const uint8_t> source);
+		/// 'destination' has to be exactly the size of the uncompressed data
+		/// returns false when the compressed data is malformed
+		[[nodiscard]] static bool decompress(std::span<const uint8_t> source, std::span<uint8_t> destination);
+	};
+}
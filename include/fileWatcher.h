@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Minecraft::IO {
+	/// handle to a file that is being watched, shared by everyone watching the same file
+	class FileWatch {
+	public:
+		/// true once after the file has changed, no matter how often it changed since the last call
+		/// a single atomic load while nothing has changed, so it's fine to call every frame
+		bool poll();
+
+		const std::filesystem::path& getPath() const;
+
+		friend class FileWatcher;
+
+	private:
+		FileWatch(std::filesystem::path path);
+
+		std::filesystem::path path;
+		std::atomic<bool> changed = false;
+	};
+
+	/// watches files for changes on a background thread, instead of asking the file system every frame
+	/// on linux the directories of the files are watched with inotify, so the thread sleeps until something is written
+	/// elsewhere the thread checks the modification times of the watched files a few times per second
+	class FileWatcher {
+	public:
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		~FileWatcher();
+
+		static FileWatcher& get();
+
+		/// the file is watched for as long as the handle is alive
+		/// a file that is replaced by renaming another file over it, like most editors save, counts as changed
+		[[nodiscard]] std::shared_ptr<FileWatch> watch(const std::filesystem::path& path);
+
+	private:
+		FileWatcher();
+
+		struct Entry {
+			std::weak_ptr<FileWatch> watch;
+			/// only used when polling
+			std::filesystem::file_time_type lastWriteTime = {};
+		};
+
+		void run();
+		/// marks the file as changed if anyone is watching it, expects the mutex to be locked
+		void notify(const std::filesystem::path& path);
+
+		std::mutex mutex;
+		std::unordered_map<std::filesystem::path, Entry> files = {};
+
+		std::atomic<bool> isRunning = true;
+		std::thread thread;
+
+#ifdef __linux__
+		int inotify = -1;
+		/// written to wake the thread up when the watcher is destroyed
+		int wakeUp = -1;
+		std::unordered_map<int, std::filesystem::path> directories = {};
+#else
+		std::condition_variable wakeUp;
+		static constexpr std::chrono::milliseconds POLL_INTERVAL = std::chrono::milliseconds(250);
+#endif
+	};
+}
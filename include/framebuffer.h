@@ -0,0 +1,33 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace Minecraft::Assets {
+	/// offscreen render target with an rgba8 color and a 24 bit depth attachment
+	/// used to render without a visible window, such as in benchmark runs
+	class Framebuffer {
+	public:
+		Framebuffer(glm::ivec2 size);
+
+		Framebuffer(const Framebuffer&) = delete;
+		Framebuffer& operator=(const Framebuffer&) = delete;
+		~Framebuffer();
+
+		/// binds for drawing and sets the viewport to the size of the framebuffer
+		void bind();
+		/// binds the default framebuffer again, the viewport is left as is
+		static void unbind();
+
+		/// false when the driver doesn't support the attachments
+		bool isComplete() const;
+		glm::ivec2 getSize() const;
+
+	private:
+		GLuint framebuffer = 0;
+		GLuint color = 0;
+		GLuint depth = 0;
+
+		glm::ivec2 size = { 0, 0 };
+	};
+}
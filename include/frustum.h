@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Minecraft::Render {
+	/// axis aligned bounding box in world space
+	struct AABB {
+		glm::vec3 min = glm::vec3(0);
+		glm::vec3 max = glm::vec3(0);
+	};
+
+	// the batched test loads boxes as 6 consecutive floats
+	static_assert(sizeof(AABB) == 6 * sizeof(float));
+
+	/// the 6 planes of a view volume, used to skip drawing anything outside of it
+	/// the batched test checks 4 boxes at once with SSE2 when available,
+	/// and gives the same results as testing every box on its own
+	class Frustum {
+	public:
+		Frustum() = default;
+		/// extracts the planes from 'projection * view', with clip space depth in [-1, 1]
+		Frustum(const glm::mat4& viewProjection);
+
+		/// true if the box is at least partially inside, boxes close to a corner can be kept although they're outside
+		bool isVisible(const AABB& box) const;
+		/// visible[i] = isVisible(boxes[i]), returns the amount of visible boxes
+		size_t cull(std::span<const AABB> boxes, std::span<uint8_t> visible) const;
+
+	private:
+		/// left, right, bottom, top, near, far, as normal and distance, with the normals pointing inwards
+		std::array<glm::vec4, 6> planes = {};
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string_view>
+
+// MINECRAFT_GL_DEBUG is set by cmake for debug builds, see the option of the same name
+// without it, none of the checks below cost anything on the hot path
+
+namespace Minecraft::Render {
+	/// routes driver messages from KHR_debug to std::cerr, prefixed with the debug groups they happened in
+	/// the groups are what ties a message to the code that caused it, the callback doesn't look up object labels itself
+	/// returns false if the context doesn't support it, or when built without MINECRAFT_GL_DEBUG
+	bool enableDebugOutput();
+
+	/// names an object in graphics debuggers, some drivers also quote the name in their messages
+	void setLabel(GLenum identifier, GLuint object, std::string_view label);
+
+	/// explains the likely cause of an error caused by a draw call
+	/// 'function' is the draw call that was made, for the messages
+	void reportDrawError(GLenum error, std::string_view function, GLenum shape);
+
+	/// checks glGetError after a draw, which waits for the driver so it's left out of builds without MINECRAFT_GL_DEBUG
+	inline void checkDrawError(std::string_view function, GLenum shape) {
+#ifdef MINECRAFT_GL_DEBUG
+		if (GLenum error = glGetError(); error != GL_NO_ERROR)
+			reportDrawError(error, function, shape);
+#endif
+	}
+
+	/// every driver message between construction and destruction is reported as part of this group
+	class DebugGroup {
+	public:
+		DebugGroup(std::string_view name);
+
+		DebugGroup(const DebugGroup&) = delete;
+		DebugGroup& operator=(const DebugGroup&) = delete;
+		~DebugGroup();
+	};
+}
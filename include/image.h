@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Minecraft::Assets {
+	/// rgba8 pixels on the cpu, rows from top to bottom
+	class Image {
+	public:
+		Image() = default;
+		/// fully transparent black
+		Image(glm::ivec2 size);
+		Image(const uint8_t* pixels, glm::ivec2 size);
+
+		/// decodes qoi, or any format stb_image supports
+		[[nodiscard]] static std::shared_ptr<Image> load(const std::filesystem::path& path);
+		/// the contents of an image file, returns nullptr if it can't be decoded
+		[[nodiscard]] static std::shared_ptr<Image> decode(std::span<const uint8_t> data);
+
+		glm::ivec2 getSize() const;
+		bool isEmpty() const;
+
+		uint8_t* getData();
+		const uint8_t* getData() const;
+		size_t getByteSize() const;
+
+		/// nearest neighbour
+		Image resized(glm::ivec2 size) const;
+		/// part of the image, the region has to be within the image
+		Image cropped(glm::ivec2 offset, glm::ivec2 size) const;
+		/// tiles of 'tileSize', from left to right, top to bottom, the remainder at the edges is dropped
+		std::vector<Image> split(glm::ivec2 tileSize) const;
+
+		/// half the size, rounded down but at least 1, by averaging 2x2 texels
+		/// colors are weighted by alpha, so the color of transparent texels doesn't bleed into the result
+		Image downsampled() const;
+		/// this image followed by every downsampled level down to 1x1
+		std::vector<Image> mipChain() const;
+
+	private:
+		glm::ivec2 size = { 0, 0 };
+
+		std::vector<uint8_t> pixels = {};
+	};
+}
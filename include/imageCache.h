@@ -0,0 +1,39 @@
+#pragma once
+
+#include "image.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace Minecraft::Assets {
+	struct ImageCacheStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+
+	/// decoded images kept on disk, so a texture is only decoded again once its file changes
+	/// entries are found by a hash of the source path, and only used while the size and modification time of the source match
+	/// safe to use from multiple threads
+	class ImageCache {
+	public:
+		ImageCache(std::filesystem::path directory);
+
+		/// the cached pixels when they are up to date, otherwise decodes the file and stores the result
+		[[nodiscard]] std::shared_ptr<Image> load(const std::filesystem::path& path);
+
+		ImageCacheStats getStats() const;
+
+	private:
+		std::filesystem::path getEntryPath(const std::string& source) const;
+
+		std::shared_ptr<Image> read(const std::filesystem::path& entry, const std::string& source, uint64_t modified, uint64_t size) const;
+		void write(const std::filesystem::path& entry, const std::string& source, uint64_t modified, uint64_t size, const Image& image);
+
+		std::filesystem::path directory;
+
+		std::atomic<uint64_t> hits = 0;
+		std::atomic<uint64_t> misses = 0;
+	};
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Minecraft::Jobs {
+	enum class Priority : uint8_t {
+		HIGH,
+		NORMAL,
+		LOW,
+	};
+
+	constexpr int PRIORITY_COUNT = 3;
+
+	/// shared between whoever submitted a job and the worker running it
+	class JobHandle {
+	public:
+		JobHandle() = default;
+
+		/// prevents the job from running if it hasn't started yet
+		/// returns true if the job will not run
+		bool cancel();
+
+		bool isValid() const;
+		bool isCancelled() const;
+		bool isDone() const;
+
+		friend class JobSystem;
+
+	private:
+		enum class Status : uint8_t {
+			PENDING,
+			RUNNING,
+			DONE,
+			CANCELLED,
+		};
+
+		struct State {
+			std::atomic<Status> status = Status::PENDING;
+		};
+
+		JobHandle(std::shared_ptr<State> state);
+
+		std::shared_ptr<State> state = nullptr;
+	};
+
+	struct WorkerStats {
+		uint64_t jobsExecuted = 0;
+		uint64_t jobsStolen = 0;
+		uint64_t jobsCancelled = 0;
+		std::chrono::nanoseconds busyTime = {};
+		/// busy time divided by the time since the stats were last reset
+		float utilisation = 0;
+	};
+
+	/// pool of workers that each own a deque per priority
+	/// workers take their own newest jobs first, and steal the oldest jobs of other workers when they run out of that priority
+	/// lower priorities only run once no worker has a higher priority job queued
+	class JobSystem {
+	public:
+		JobSystem(size_t workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+		~JobSystem();
+
+		JobHandle submit(std::function<void()> job, Priority priority = Priority::NORMAL);
+
+		/// queues work that has to happen on the thread owning the GL context, such as buffer uploads
+		void submitToMainThread(std::function<void()> job);
+		/// runs queued main thread jobs until the queue is empty or the budget is used up
+		/// returns the amount of jobs that were run
+		size_t runMainThreadJobs(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+		/// blocks until every submitted job has finished, the calling thread helps out in the meantime
+		void waitIdle();
+
+		size_t getWorkerCount() const;
+		size_t getPendingCount() const;
+		size_t getMainThreadPendingCount() const;
+
+		std::vector<WorkerStats> getStats() const;
+		void resetStats();
+
+	private:
+		struct Job {
+			std::function<void()> function;
+			std::shared_ptr<JobHandle::State> state;
+		};
+
+		struct Worker {
+			mutable std::mutex mutex;
+			std::array<std::deque<Job>, PRIORITY_COUNT> queues;
+
+			std::thread thread;
+
+			std::atomic<uint64_t> jobsExecuted = 0;
+			std::atomic<uint64_t> jobsStolen = 0;
+			std::atomic<uint64_t> jobsCancelled = 0;
+			std::atomic<int64_t> busyNanoseconds = 0;
+		};
+
+		void workerLoop(size_t index);
+
+		/// the highest priority job there is, preferring the worker's own jobs within a priority
+		bool take(size_t index, Job& job);
+		bool popOwn(size_t index, size_t priority, Job& job);
+		bool steal(size_t thief, size_t priority, Job& job);
+		void run(Worker& worker, Job& job);
+
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		std::atomic<bool> isRunning = true;
+		/// jobs sitting in a deque, workers sleep when this is 0
+		std::atomic<size_t> queued = 0;
+		/// jobs that are queued or running
+		std::atomic<size_t> unfinished = 0;
+		std::atomic<size_t> nextWorker = 0;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+
+		mutable std::mutex mainThreadMutex;
+		std::deque<std::function<void()>> mainThreadJobs;
+
+		std::atomic<int64_t> statsStart = 0;
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "chunk.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Minecraft::World {
+	/// the 3x3 chunks around a center chunk, which is as far as light from the center chunk can reach
+	/// a lighting job only touches the chunks of its region, so jobs with regions that don't overlap can run at the same time
+	class LightRegion {
+	public:
+		static constexpr int WIDTH = 3;
+		static constexpr int CHUNK_COUNT = WIDTH * WIDTH;
+
+		/// 'chunks' are in 'x + z * WIDTH' order, starting at 'center - 1', missing chunks are nullptr and get no light
+		LightRegion(glm::ivec2 center, std::array<std::shared_ptr<Chunk>, CHUNK_COUNT> chunks);
+
+		glm::ivec2 getCenter() const;
+		/// nullptr if the chunk isn't part of the region, or missing
+		Chunk* getChunk(glm::ivec2 chunkPosition) const;
+
+		/// chunks of which blocks or light changed, including neighbours of changes on their border, as those have faces facing it
+		std::vector<glm::ivec2> getChangedChunks() const;
+
+		/// blocks along x and z
+		static constexpr int SIZE = WIDTH * ChunkSection::SIZE;
+
+		/// the positions below are relative to the corner of the region, x and z are within [0, SIZE) for blocks inside it
+		glm::ivec3 toLocal(glm::ivec3 worldPosition) const;
+		/// false outside of the region, and in missing chunks
+		bool contains(glm::ivec3 position) const;
+
+		BlockId getBlock(glm::ivec3 position) const;
+		void setBlock(glm::ivec3 position, BlockId block);
+		uint8_t getLight(LightType type, glm::ivec3 position) const;
+		void setLight(LightType type, glm::ivec3 position, uint8_t level);
+
+	private:
+		Chunk& chunkAt(glm::ivec3 position) const;
+		void markChanged(glm::ivec3 position);
+
+		glm::ivec2 center = { 0, 0 };
+		std::array<std::shared_ptr<Chunk>, CHUNK_COUNT> chunks = {};
+		std::array<bool, CHUNK_COUNT> changed = {};
+	};
+
+	/// flood fills block light and sky light, and keeps it up to date when blocks change,
+	/// by only taking away and spreading light where it differs from before
+	class Lighting {
+	public:
+		/// lights a chunk as if it had no neighbours, 'spreadBorders' connects it to them later
+		static void lightChunk(Chunk& chunk);
+
+		/// spreads light across the borders of the center chunk, in both directions
+		static void spreadBorders(LightRegion& region);
+
+		/// replaces the block at 'position', in world coordinates, and updates the light around it
+		/// the position has to be in the center chunk of the region, returns false if it's outside of it or the block didn't change
+		static bool setBlock(LightRegion& region, glm::ivec3 position, BlockId block);
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace Minecraft::IO {
+	/// file that is read through a memory mapping, so reading is a page fault instead of a copy
+	/// writes go through the file handle, the mapping is grown when a write extends the file
+	class MappedFile {
+	public:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		/// opens the file read only, returns nullptr if it can't be opened
+		[[nodiscard]] static std::shared_ptr<MappedFile> open(const std::filesystem::path& path);
+		/// opens the file for reading and writing, creating it when it doesn't exist yet
+		[[nodiscard]] static std::shared_ptr<MappedFile> openWritable(const std::filesystem::path& path);
+
+		/// the whole file, empty when the file is
+		std::span<const uint8_t> getData() const;
+		size_t getSize() const;
+
+		bool write(size_t offset, std::span<const uint8_t> data);
+		/// blocks until everything written so far is on disk
+		bool sync();
+
+	private:
+		MappedFile() = default;
+
+		bool map(size_t size);
+		void unmap();
+		void close();
+
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#else
+		int file = -1;
+#endif
+		bool isWritable = false;
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "chunk.h"
+#include "block.h"
+#include "visibility.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Minecraft::World {
+	/// 8 byte vertex, unpacked by 'chunk.vert'
+	/// texcoords aren't stored, the shader derives them from the position and the face
+	struct ChunkVertex {
+		/// x, y and z relative to the section origin in 5 bits each (0 - 16), face in 3 bits, ambient occlusion in 2 bits
+		uint32_t position;
+		/// texture index in 16 bits, block light in 4 bits, sky light in 4 bits
+		uint32_t texture;
+
+		static constexpr ChunkVertex pack(glm::ivec3 pos, Face face, uint8_t ao, uint16_t texture, uint8_t blockLight, uint8_t skyLight) {
+			return {
+				uint32_t(pos.x) | uint32_t(pos.y) << 5 | uint32_t(pos.z) << 10 | uint32_t(face) << 15 | uint32_t(ao & 0x3) << 18,
+				uint32_t(texture) | uint32_t(blockLight & 0xF) << 16 | uint32_t(skyLight & 0xF) << 20,
+			};
+		}
+
+		constexpr glm::ivec3 getPosition() const { return { int(position & 0x1F), int((position >> 5) & 0x1F), int((position >> 10) & 0x1F) }; }
+		constexpr Face getFace() const { return static_cast<Face>((position >> 15) & 0x7); }
+		/// 0 is fully occluded, 3 is not occluded
+		constexpr uint8_t getAmbientOcclusion() const { return (position >> 18) & 0x3; }
+		constexpr uint16_t getTexture() const { return texture & 0xFFFF; }
+		constexpr uint8_t getBlockLight() const { return (texture >> 16) & 0xF; }
+		constexpr uint8_t getSkyLight() const { return (texture >> 20) & 0xF; }
+	};
+
+	static_assert(sizeof(ChunkVertex) == 8);
+
+	struct ChunkMesh {
+		std::vector<ChunkVertex> vertices = {};
+		std::vector<uint32_t> indices = {};
+
+		/// amount of block faces covered by the quads, equal to the quad count when meshing without merging
+		size_t faceCount = 0;
+
+		/// bounds of the vertices relative to the section origin, used for culling
+		glm::ivec3 min = glm::ivec3(0);
+		glm::ivec3 max = glm::ivec3(0);
+
+		/// connectivity of the section faces, for culling sections hidden behind terrain
+		Visibility visibility = {};
+
+		size_t getQuadCount() const { return vertices.size() / 4; }
+		bool isEmpty() const { return indices.empty(); }
+	};
+
+	/// light of a section and its neighbours in the order of 'Face', nullptr has the default light of 'SectionLight'
+	struct MeshLight {
+		const SectionLight* section = nullptr;
+		std::array<const SectionLight*, FACE_COUNT> neighbours = {};
+	};
+
+	/// turns sections into geometry, only using the cpu so it can run on any thread
+	class Mesher {
+	public:
+		/// neighbouring sections in the order of 'Face', nullptr is treated as air
+		using Neighbours = std::array<const ChunkSection*, FACE_COUNT>;
+
+		/// emits the faces not hidden by opaque blocks, lit by the light of the block in front of them,
+		/// when 'greedy' is set coplanar faces with the same texture, light and ambient occlusion are merged into larger quads
+		/// blocks of diagonal neighbours aren't known, so ambient occlusion treats those as air
+		[[nodiscard]] static ChunkMesh mesh(const ChunkSection& section, const Neighbours& neighbours = {}, bool greedy = true, const MeshLight& light = {});
+	};
+}
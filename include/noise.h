@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Minecraft::World {
+	/// seeded 3d gradient noise (improved perlin noise), roughly in the range [-1, 1]
+	/// the batched overload evaluates 4 points at once with SSE2 when available,
+	/// and gives the same results as sampling every point on its own
+	class Noise {
+	public:
+		Noise(uint32_t seed = 0);
+
+		float sample(float x, float y, float z) const;
+		/// out[i] = sample(x[i], y[i], z[i])
+		void sample(const float* x, const float* y, const float* z, float* out, size_t count) const;
+
+	private:
+		/// a permutation of [0, 256), repeated twice so lookups of 'index + 1' don't need to wrap
+		std::array<int32_t, 512> permutation = {};
+	};
+}
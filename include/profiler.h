@@ -0,0 +1,142 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Minecraft::Profiling {
+	struct Zone {
+		/// has to outlive the profiler, usually a string literal
+		const char* name = nullptr;
+		/// nanoseconds on the steady clock, gpu zones are converted to it
+		int64_t start = 0;
+		int64_t end = 0;
+		/// amount of zones this one is nested in, on the same thread or on the gpu
+		uint16_t depth = 0;
+		/// index into 'Profiler::getThreadNames', 0 for gpu zones
+		uint16_t thread = 0;
+	};
+
+	struct FrameProfile {
+		uint64_t index = 0;
+		int64_t start = 0;
+		int64_t end = 0;
+		/// every zone that ended during the frame, on any thread, sorted by start
+		std::vector<Zone> cpuZones = {};
+		std::vector<Zone> gpuZones = {};
+		/// gpu zones arrive a few frames late, as their queries are only read once the gpu has passed them
+		bool isGpuComplete = false;
+	};
+
+	/// collects timed zones per frame, from every thread for the cpu and through timestamp queries for the gpu
+	/// zones are cheap enough to leave in, and do nothing while the profiler is disabled and no trace is recorded
+	/// frames are started and ended on the thread owning the GL context
+	class Profiler {
+	public:
+		/// amount of frames kept in the history
+		static constexpr size_t HISTORY_SIZE = 300;
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		static Profiler& get();
+		/// nanoseconds on the steady clock
+		static int64_t now();
+
+		void setEnabled(bool enabled);
+		bool isEnabled() const;
+
+		/// shown on the timeline instead of 'thread n'
+		void setThreadName(const std::string& name);
+		std::vector<std::string> getThreadNames() const;
+
+		void beginFrame();
+		/// collects the zones of every thread, and reads back the gpu zones of earlier frames that are done
+		void endFrame();
+
+		/// oldest first, the last frame can still be missing its gpu zones
+		const std::deque<FrameProfile>& getFrames() const;
+
+		friend class CpuZone;
+		friend class GpuZone;
+
+	private:
+		Profiler() = default;
+
+		struct ThreadBuffer {
+			std::mutex mutex;
+			std::vector<Zone> zones;
+			std::string name;
+			uint16_t index = 0;
+			/// only touched by the thread itself
+			uint16_t depth = 0;
+		};
+
+		struct PendingGpuZone {
+			const char* name = nullptr;
+			uint16_t depth = 0;
+			uint64_t frame = 0;
+			GLuint startQuery = 0;
+			GLuint endQuery = 0;
+		};
+
+		ThreadBuffer& getThreadBuffer();
+
+		GLuint acquireQuery();
+		void readGpuZones();
+
+		std::atomic<bool> enabled = true;
+
+		mutable std::mutex threadsMutex;
+		std::vector<std::shared_ptr<ThreadBuffer>> threads;
+
+		uint64_t frameIndex = 0;
+		int64_t frameStart = 0;
+		std::deque<FrameProfile> frames;
+
+		/// references stay valid when pushing to the back and popping from the front
+		std::deque<PendingGpuZone> pendingGpuZones;
+		std::vector<GLuint> freeQueries;
+		uint16_t gpuDepth = 0;
+		/// added to gpu timestamps to put them on the steady clock
+		int64_t gpuOffset = 0;
+		int64_t lastGpuSync = 0;
+	};
+
+	/// measures the cpu time until it goes out of scope, on any thread
+	class CpuZone {
+	public:
+		CpuZone(const char* name);
+
+		CpuZone(const CpuZone&) = delete;
+		CpuZone& operator=(const CpuZone&) = delete;
+		~CpuZone();
+
+	private:
+		const char* name = nullptr;
+		int64_t start = 0;
+		/// nullptr when the profiler was disabled when the zone started
+		Profiler::ThreadBuffer* buffer = nullptr;
+	};
+
+	/// measures the time the gpu spends on the commands issued until it goes out of scope
+	/// only to be used from the thread owning the GL context
+	class GpuZone {
+	public:
+		GpuZone(const char* name);
+
+		GpuZone(const GpuZone&) = delete;
+		GpuZone& operator=(const GpuZone&) = delete;
+		~GpuZone();
+
+	private:
+		Profiler::PendingGpuZone* zone = nullptr;
+	};
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <filesystem>
+#include <string>
+
+namespace Minecraft::Assets {
+	/// linked programs kept on disk, so a later launch doesn't have to compile and link them again
+	/// entries are found by a hash of the key, which has to describe everything the program is built from
+	/// the driver is part of every key, as binaries are only valid for the driver that made them
+	/// only to be used from the thread owning the GL context
+	class ProgramBinaryCache {
+	public:
+		ProgramBinaryCache(std::filesystem::path directory);
+
+		/// false when the driver has no binary formats, loading always fails then
+		bool isSupported() const;
+
+		/// links 'program' from the cached binary, returns false if there is none or the driver rejected it
+		bool load(GLuint program, const std::string& key);
+		/// the program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+		void store(GLuint program, const std::string& key);
+
+	private:
+		std::filesystem::path getEntryPath(const std::string& key) const;
+
+		std::filesystem::path directory;
+		/// vendor, renderer and version
+		std::string driver;
+		bool supported = false;
+	};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "chunk.h"
+#include "mappedFile.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Minecraft::World {
+	/// 32x32 chunks stored in one file, read through a memory mapping
+	/// the file starts with a table of where every chunk is stored, followed by the compressed chunks,
+	/// everything aligned to 4 KiB sectors
+	///
+	/// writes never overwrite the sectors of the chunk that's being replaced, the new data is written and synced first,
+	/// and only then the table entry is updated, so a crash leaves either the old or the new chunk
+	/// safe to use from multiple threads
+	class RegionFile {
+	public:
+		static constexpr int SIZE = 32;
+		static constexpr int CHUNK_COUNT = SIZE * SIZE;
+		static constexpr size_t SECTOR_SIZE = 4096;
+
+		RegionFile(const RegionFile&) = delete;
+		RegionFile& operator=(const RegionFile&) = delete;
+
+		/// creates the file when it doesn't exist yet, returns nullptr if it can't be opened or isn't a region file
+		[[nodiscard]] static std::shared_ptr<RegionFile> open(const std::filesystem::path& path);
+
+		bool hasChunk(glm::ivec2 position) const;
+		/// nullptr when the chunk isn't stored, or is damaged
+		std::shared_ptr<Chunk> read(glm::ivec2 position) const;
+		bool write(const Chunk& chunk);
+
+		/// seconds since the unix epoch of the last write of the chunk, 0 if it isn't stored
+		uint32_t getTimestamp(glm::ivec2 position) const;
+		size_t getSectorCount() const;
+		size_t getUsedSectorCount() const;
+
+		/// chunk position to the position of the region containing it
+		static glm::ivec2 regionPosition(glm::ivec2 chunkPosition);
+
+	private:
+		RegionFile() = default;
+
+		static int index(glm::ivec2 chunkPosition);
+
+		/// first sector of a run of 'count' free sectors, which can run past the end of the file
+		uint32_t allocate(uint32_t count) const;
+
+		std::shared_ptr<IO::MappedFile> file = nullptr;
+
+		/// sector offset << 8 | sector count, 0 when the chunk isn't stored
+		std::array<uint32_t, CHUNK_COUNT> locations = {};
+		std::array<uint32_t, CHUNK_COUNT> timestamps = {};
+		/// one entry per sector of the file, including the header
+		std::vector<bool> usedSectors = {};
+
+		/// reads share the lock, writes are exclusive as they can remap the file
+		mutable std::shared_mutex mutex;
+	};
+
+	/// chunks of a world on disk, one region file per 32x32 chunks, opened on first use
+	/// safe to use from multiple threads
+	class RegionStorage {
+	public:
+		RegionStorage(std::filesystem::path directory);
+
+		RegionStorage(const RegionStorage&) = delete;
+		RegionStorage& operator=(const RegionStorage&) = delete;
+
+		/// nullptr if the chunk was never saved
+		std::shared_ptr<Chunk> load(glm::ivec2 position);
+		bool save(const Chunk& chunk);
+
+		const std::filesystem::path& getDirectory() const;
+		size_t getRegionCount() const;
+
+	private:
+		/// nullptr when the region file can't be opened, or doesn't exist and 'create' isn't set
+		std::shared_ptr<RegionFile> getRegion(glm::ivec2 regionPosition, bool create);
+
+		std::filesystem::path directory;
+
+		std::unordered_map<glm::ivec2, std::shared_ptr<RegionFile>, ChunkPositionHash> regions = {};
+		mutable std::mutex mutex;
+	};
+}
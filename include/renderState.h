@@ -0,0 +1,143 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Minecraft::Render {
+	struct RenderStateStats {
+		/// state changes passed on to the driver
+		uint64_t issued = 0;
+		/// state changes skipped because the state was already set
+		uint64_t elided = 0;
+	};
+
+	struct BlendFunc {
+		GLenum sourceRGB = GL_ONE;
+		GLenum destinationRGB = GL_ZERO;
+		GLenum sourceAlpha = GL_ONE;
+		GLenum destinationAlpha = GL_ZERO;
+
+		bool operator==(const BlendFunc&) const = default;
+	};
+
+	struct BlendEquation {
+		GLenum rgb = GL_FUNC_ADD;
+		GLenum alpha = GL_FUNC_ADD;
+
+		bool operator==(const BlendEquation&) const = default;
+	};
+
+	/// copy of the GL state on the cpu, so setting state that is already set doesn't reach the driver,
+	/// and reading it back doesn't have to wait for the driver
+	/// this only works if every change goes through here, call 'reset' after code that changes the state itself
+	/// objects also have to be deleted through here, as GL unbinds them and can hand out their name again
+	/// only to be used from the thread owning the GL context
+	class RenderState {
+	public:
+		RenderState(const RenderState&) = delete;
+		RenderState& operator=(const RenderState&) = delete;
+
+		/// there is only one context, so only one state
+		/// reads the state from the driver the first time
+		static RenderState& get();
+
+		/// reads the state back from the driver, bindings are forgotten so the next bind is always issued
+		void reset();
+
+		void setEnabled(GLenum capability, bool enabled);
+		/// capabilities that weren't set yet are asked from the driver once
+		bool isEnabled(GLenum capability);
+
+		void setDepthFunc(GLenum function);
+		GLenum getDepthFunc() const;
+		void setBlendFunc(const BlendFunc& function);
+		BlendFunc getBlendFunc() const;
+		void setBlendEquation(const BlendEquation& equation);
+		BlendEquation getBlendEquation() const;
+		void setBlendColor(const glm::vec4& color);
+		glm::vec4 getBlendColor() const;
+		void setCullFace(GLenum face);
+		GLenum getCullFace() const;
+		void setFrontFace(GLenum orientation);
+		GLenum getFrontFace() const;
+		/// for both front and back faces, as core profiles don't allow setting them separately
+		void setPolygonMode(GLenum mode);
+		GLenum getPolygonMode() const;
+		void setPointSize(float size);
+		float getPointSize() const;
+		void setLineWidth(float width);
+		float getLineWidth() const;
+
+		void useProgram(GLuint program);
+		GLuint getProgram() const;
+		void bindVertexArray(GLuint vertexArray);
+		GLuint getVertexArray() const;
+		/// GL_ELEMENT_ARRAY_BUFFER is part of the vertex array, so it's always issued
+		void bindBuffer(GLenum target, GLuint buffer);
+		/// a size of 0 binds the whole buffer, also sets the generic binding of 'target' like GL does
+		void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset = 0, GLsizeiptr size = 0);
+		void bindTexture(GLuint unit, GLuint texture);
+		/// 0 if nothing was bound to the unit since the last reset
+		GLuint getTexture(GLuint unit) const;
+
+		void deleteBuffers(GLsizei count, const GLuint* buffers);
+		void deleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+		void deleteTextures(GLsizei count, const GLuint* textures);
+		void deleteProgram(GLuint program);
+
+		RenderStateStats getStats() const;
+		void resetStats();
+
+	private:
+		RenderState();
+
+		/// counts the change, and returns true if it can be skipped
+		bool isRedundant(bool unchanged);
+
+		struct BufferRange {
+			GLuint buffer = 0;
+			GLintptr offset = 0;
+			GLsizeiptr size = 0;
+
+			bool operator==(const BufferRange&) const = default;
+		};
+
+		struct IndexedTarget {
+			GLenum target = 0;
+			GLuint index = 0;
+
+			bool operator==(const IndexedTarget&) const = default;
+		};
+
+		struct IndexedTargetHash {
+			size_t operator()(const IndexedTarget& key) const {
+				return std::hash<uint64_t>()((uint64_t(key.target) << 32) | key.index);
+			}
+		};
+
+		std::unordered_map<GLenum, bool> capabilities = {};
+
+		GLenum depthFunc = GL_LESS;
+		BlendFunc blendFunc = {};
+		BlendEquation blendEquation = {};
+		glm::vec4 blendColor = glm::vec4(0);
+		GLenum cullFace = GL_BACK;
+		GLenum frontFace = GL_CCW;
+		GLenum polygonMode = GL_FILL;
+		float pointSize = 1;
+		float lineWidth = 1;
+
+		GLuint program = 0;
+		GLuint vertexArray = 0;
+		/// bindings that aren't in here are unknown
+		std::unordered_map<GLenum, GLuint> buffers = {};
+		std::unordered_map<IndexedTarget, BufferRange, IndexedTargetHash> bufferRanges = {};
+		std::unordered_map<GLuint, GLuint> textures = {};
+
+		RenderStateStats stats = {};
+	};
+}
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "fileWatcher.h"
+#include "programBinaryCache.h"
+
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include <array>
 #include <string>
 #include <optional>
+#include <unordered_map>
 #include <filesystem>
 #include <vector>
 #include <memory>
@@ -25,12 +30,17 @@ namespace Minecraft::Assets {
 		Shader& operator=(Shader&& other) noexcept;
 		~Shader();
 
+		/// starts recompiling once the file has changed, and swaps the new shader in once the driver is done with it
+		/// the compile doesn't block the frame it starts in when the driver supports parallel shader compiles
+		/// returns true when the shader was swapped, and the programs using it were relinked
 		bool update();
 
 		bool loadShaderSource(const std::string& source);
 		bool loadShaderSource(const std::vector<std::string>& sources);
 
 		[[nodiscard]] static std::shared_ptr<Shader> parse(const std::filesystem::path& path);
+		/// the source is only compiled once a program using it is linked, and not at all when that program comes from a binary cache
+		/// compile errors are reported when linking
 		[[nodiscard]] static std::shared_ptr<Shader> parse(std::filesystem::path path, GLenum shaderType);
 		[[nodiscard]] static std::shared_ptr<Shader> parse(const std::string& source, GLenum shaderType);
 
@@ -39,10 +49,28 @@ namespace Minecraft::Assets {
 		friend class ShaderProgram;
 
 	private:
+		/// uploads the source without compiling it
+		bool setSource(const std::string& source);
+		/// compiles the uploaded source
+		bool compile();
+
 		GLuint shader = 0;
+		GLenum type = 0;
+
+		/// kept to describe the shader in the key of a program binary
+		std::string source = {};
+		bool compiled = false;
 
 		std::optional<std::filesystem::path> path = {};
-		std::filesystem::file_time_type lastTimeStamp = std::filesystem::file_time_type::min();
+		std::shared_ptr<IO::FileWatch> watch = nullptr;
+		/// the recompile of a changed file, 0 when there is none
+		GLuint pending = 0;
+		std::string pendingSource = {};
+
+		/// starts compiling the current contents of the file into 'pending'
+		void recompile();
+		/// replaces the shader with 'pending' in every program using it, or drops it if it didn't compile
+		bool swapPending();
 
 		std::vector<std::weak_ptr<ShaderProgram>> programs = {};
 	};
@@ -61,11 +89,14 @@ namespace Minecraft::Assets {
 		std::shared_ptr<ShaderProgram> attachShader(std::weak_ptr<Shader> shader);
 		std::shared_ptr<ShaderProgram> detachShader(std::weak_ptr<Shader> shader);
 		std::shared_ptr<ShaderProgram> bindAttribute(GLuint index, const std::string& name);
+		/// linking tries the cache first, and stores the result when it had to link from source
+		std::shared_ptr<ShaderProgram> useBinaryCache(std::shared_ptr<ProgramBinaryCache> cache);
 		std::shared_ptr<ShaderProgram> link();
 		std::shared_ptr<ShaderProgram> use();
 
 		bool update();
 
+		/// locations are looked up once when linking, and again after every relink, -1 if the uniform isn't active
 		[[nodiscard]] GLint getUniform(const std::string& uniform) const;
 
 		void setUniform(const std::string& uniform, bool val) { setUniform(getUniform(uniform), val); };
@@ -77,6 +108,8 @@ namespace Minecraft::Assets {
 		void setUniform(const std::string& uniform, const glm::vec3& val) { setUniform(getUniform(uniform), val); };
 		void setUniform(const std::string& uniform, const glm::vec2& val) { setUniform(getUniform(uniform), val); };
 
+		/// values are set on the program directly, so it doesn't need to be in use
+		/// setting a uniform to the value it already has is skipped
 		void setUniform(GLint uniform, bool val);
 		void setUniform(GLint uniform, int val);
 		void setUniform(GLint uniform, float val);
@@ -91,8 +124,27 @@ namespace Minecraft::Assets {
 	private:
 		ShaderProgram();
 
+		/// last value set per uniform, the largest uniform type is a 4x4 matrix
+		struct UniformValue {
+			std::array<float, 16> data = {};
+			size_t size = 0;
+		};
+
+		/// returns true if the uniform already has this value, and remembers it otherwise
+		bool isCached(GLint uniform, const float* data, size_t size);
+		void cacheUniformLocations();
+		/// the sources of the shaders and the bound attributes, everything the linked program depends on
+		std::string getBinaryKey() const;
+
 		GLuint program = 0;
+		/// result of the last link, so using the program doesn't have to ask the driver
+		bool linked = false;
 
 		std::vector<std::shared_ptr<Shader>> shaders = {};
+		std::vector<std::pair<GLuint, std::string>> attributes = {};
+		std::shared_ptr<ProgramBinaryCache> binaryCache = nullptr;
+
+		std::unordered_map<std::string, GLint> uniformLocations = {};
+		std::unordered_map<GLint, UniformValue> uniformValues = {};
 	};
 }
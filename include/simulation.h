@@ -0,0 +1,109 @@
+#pragma once
+
+#include "tripleBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Minecraft::Game {
+	/// everything the renderer needs to know about a tick
+	struct GameState {
+		uint64_t tick = 0;
+		/// seconds of simulated time
+		double time = 0;
+
+		/// the camera orbits around 'target' at 'distance', angles are in radians
+		glm::vec3 target = { 0, 0, 0 };
+		float distance = 48;
+		float yaw = 0;
+		float pitch = 0;
+		float roll = 0;
+		/// yaw added by 'Input::orbitSpeed', kept apart so the yaw eases towards the input on its own
+		float orbit = 0;
+
+		glm::vec3 getCameraPosition() const;
+		glm::mat4 getView() const;
+
+		/// 'a' when 'alpha' is 0 and 'b' when 'alpha' is 1, angles take the shortest way around
+		static GameState interpolate(const GameState& a, const GameState& b, float alpha);
+	};
+
+	/// what the player asks for, the state eases towards this over a few ticks
+	struct Input {
+		float distance = 48;
+		float yaw = 0;
+		float pitch = 0;
+		float roll = 0;
+		/// radians per second the camera orbits the target by itself
+		float orbitSpeed = 0;
+	};
+
+	struct SimulationStats {
+		uint64_t ticks = 0;
+		/// ticks that were dropped because the simulation fell too far behind
+		uint64_t skippedTicks = 0;
+		std::chrono::nanoseconds lastTickTime = {};
+	};
+
+	/// runs the game logic on its own thread at a fixed tick rate, independent of how fast frames are rendered
+	/// every tick publishes the state before and after it, and 'sample' interpolates between those,
+	/// so the renderer is always one tick behind but moves smoothly at any frame rate
+	class Simulation {
+	public:
+		Simulation(const GameState& initial, double tickRate = 60);
+
+		Simulation(const Simulation&) = delete;
+		Simulation& operator=(const Simulation&) = delete;
+		~Simulation();
+
+		/// used from the next tick on
+		void setInput(const Input& input);
+		Input getInput() const;
+
+		/// the state at 'now', only called by a single thread
+		GameState sample(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+		void setTickRate(double tickRate);
+		double getTickRate() const;
+
+		SimulationStats getStats() const;
+
+	private:
+		struct Snapshot {
+			GameState previous;
+			GameState current;
+			/// when the tick that produced 'current' was due, on the steady clock
+			std::chrono::steady_clock::time_point time;
+			std::chrono::nanoseconds step;
+		};
+
+		/// at most this many ticks are run back to back to catch up, anything after that is skipped
+		static constexpr int MAX_CATCH_UP_TICKS = 5;
+
+		void run();
+		static void tick(GameState& state, const Input& input, float step);
+
+		Jobs::TripleBuffer<Snapshot> snapshots;
+		GameState state;
+
+		mutable std::mutex inputMutex;
+		Input input;
+
+		std::atomic<int64_t> stepNanoseconds;
+
+		std::atomic<uint64_t> ticks = 0;
+		std::atomic<uint64_t> skippedTicks = 0;
+		std::atomic<int64_t> lastTickNanoseconds = 0;
+
+		std::atomic<bool> running = true;
+		std::mutex wakeUpMutex;
+		std::condition_variable wakeUp;
+		std::thread thread;
+	};
+}
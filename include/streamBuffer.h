@@ -0,0 +1,75 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace Minecraft::Render {
+	struct StreamStats {
+		size_t capacity = 0;
+		uint64_t bytesLastFrame = 0;
+		uint64_t bytesTotal = 0;
+		/// time spent waiting for the gpu to finish reading a region that was about to be overwritten
+		std::chrono::nanoseconds waitTimeLastFrame = {};
+		std::chrono::nanoseconds waitTimeTotal = {};
+		uint64_t waitCount = 0;
+		/// allocations that didn't fit in what's left of the buffer this frame
+		uint64_t failedCount = 0;
+		size_t framesInFlight = 0;
+	};
+
+	/// ring buffer that stays mapped, used to stream data to the gpu without the driver allocating or stalling
+	/// the cpu writes straight into the mapping, and the gpu copies or reads from it
+	/// every frame is fenced, and a region is only reused once the gpu has passed the fence of the frame that wrote it
+	/// only to be used from the thread owning the GL context
+	class StreamBuffer {
+	public:
+		struct Allocation {
+			/// mapped memory to write to
+			uint8_t* data = nullptr;
+			/// offset in the buffer, in bytes
+			size_t offset = 0;
+		};
+
+		StreamBuffer(size_t capacity = 32 << 20);
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+		~StreamBuffer();
+
+		/// waits for the gpu when the ring would overwrite a region it's still using
+		/// returns false if the allocation doesn't fit next to what was already allocated this frame
+		[[nodiscard]] bool allocate(size_t size, size_t alignment, Allocation& allocation);
+		/// fences everything allocated since the last call, call once per frame after the commands using it are submitted
+		void endFrame();
+
+		GLuint getBuffer() const;
+		StreamStats getStats() const;
+
+	private:
+		struct Frame {
+			GLsync fence = nullptr;
+			/// write position when the frame ended, everything before it is free once the fence is signaled
+			uint64_t end = 0;
+		};
+
+		/// waits for the oldest frame, returns false if there is none
+		bool waitOldestFrame();
+
+		GLuint buffer = 0;
+		uint8_t* mapping = nullptr;
+		size_t capacity = 0;
+
+		/// positions only ever increase, the offset in the buffer is the position modulo the capacity
+		uint64_t writePosition = 0;
+		uint64_t releasedPosition = 0;
+		std::deque<Frame> frames = {};
+
+		uint64_t frameBytes = 0;
+		std::chrono::nanoseconds frameWaitTime = {};
+		StreamStats stats = {};
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "chunk.h"
+#include "noise.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Minecraft::World {
+	/// fills chunks from a 2d heightmap, shaped by 3d density noise around the surface
+	/// generating only reads shared state, so chunks can be generated on any amount of threads at once
+	class TerrainGenerator {
+	public:
+		static constexpr int BASE_HEIGHT = 64;
+		static constexpr int SEA_LEVEL = 60;
+
+		TerrainGenerator(uint32_t seed);
+
+		void generate(Chunk& chunk) const;
+
+		/// height of the surface per column, in 'x + z * SIZE' order
+		std::array<int, ChunkSection::AREA> generateHeightmap(glm::ivec2 chunkPosition) const;
+
+		uint32_t getSeed() const;
+
+		uint64_t getGeneratedCount() const;
+		std::chrono::nanoseconds getGenerationTime() const;
+		/// chunks per second of a single core, based on the time spent in 'generate'
+		double getThroughput() const;
+
+	private:
+		uint32_t seed = 0;
+
+		Noise densityNoise;
+
+		BlockId stone = AIR;
+		BlockId dirt = AIR;
+		BlockId grass = AIR;
+		BlockId sand = AIR;
+
+		mutable std::atomic<uint64_t> generatedCount = 0;
+		mutable std::atomic<int64_t> generationNanoseconds = 0;
+	};
+}
@@ -17,17 +17,30 @@ namespace Minecraft::Assets {
 		~Texture2D();
 
 		[[nodiscard]] static std::shared_ptr<Texture2D> load(std::filesystem::path path);
+		/// small checkerboard, shown while the actual texture is still loading
+		[[nodiscard]] static std::shared_ptr<Texture2D> placeholder();
+		/// paths without a directory are looked for in 'assets/textures'
+		static std::filesystem::path resolve(std::filesystem::path path);
 
+		/// binds to texture unit 0
+		/// the texture is replaced once a load finishes, so bind again every frame instead of only once
 		void bind();
 
+		/// false while this is a placeholder of a texture that is still loading
+		bool isLoaded() const;
 		glm::ivec2 getSize() const;
 		GLuint getId() const;
 
 		Texture2D(const uint8_t* data, int width, int height);
 	private:
+		friend class TextureLoader;
+
+		/// takes ownership of 'texture', and deletes the current one
+		void replace(GLuint texture, glm::ivec2 size);
 
 		GLuint texture = 0;
 
 		glm::ivec2 size = { 0, 0 };
+		bool loaded = true;
 	};
 }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "image.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Minecraft::Render {
+	class StreamBuffer;
+}
+
+namespace Minecraft::Assets {
+	/// GL_TEXTURE_2D_ARRAY with one image per layer, and a name per layer to look them up
+	/// every layer wraps on its own, so there is no bleeding between neighbours like in an atlas
+	class TextureArray {
+	public:
+		TextureArray(const TextureArray&) = delete;
+		TextureArray& operator=(const TextureArray&) = delete;
+		~TextureArray();
+
+		/// a single checkerboard layer, shown while the actual layers are still loading
+		[[nodiscard]] static std::shared_ptr<TextureArray> placeholder();
+		/// every '.qoi' and '.png' in 'directory' by the file name without extension, sorted by name
+		/// when both exist for a name the qoi is used, as it decodes faster
+		static std::map<std::string, std::filesystem::path> find(const std::filesystem::path& directory);
+
+		/// 'image' resized to 'size' if needed, followed by its mip levels
+		static std::vector<Image> buildMipChain(const std::string& name, const Image& image, glm::ivec2 size);
+		/// replaces the texture with one layer per mip chain, which all have to be built for the same size
+		/// staged through 'stream' when given, so the driver doesn't have to copy the pixels during the call
+		void upload(const std::vector<std::string>& names, const std::vector<std::vector<Image>>& mipChains, Render::StreamBuffer* stream = nullptr);
+
+		/// the array is bound to the unit, so bind again after a load finishes
+		void bind(GLuint unit);
+
+		/// false while this is a placeholder of an array that is still loading
+		bool isLoaded() const;
+		/// -1 if there is no layer with that name
+		int getLayer(const std::string& name) const;
+		const std::vector<std::string>& getLayerNames() const;
+
+		glm::ivec2 getSize() const;
+		size_t getLayerCount() const;
+		int getLevelCount() const;
+		GLuint getId() const;
+
+	private:
+		TextureArray() = default;
+
+		GLuint texture = 0;
+
+		glm::ivec2 size = { 0, 0 };
+		int levelCount = 0;
+		bool loaded = false;
+
+		std::vector<std::string> names = {};
+		std::unordered_map<std::string, int> layers = {};
+	};
+}
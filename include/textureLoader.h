@@ -0,0 +1,84 @@
+#pragma once
+
+#include "jobSystem.h"
+#include "texture.h"
+#include "textureArray.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Minecraft::Render {
+	class StreamBuffer;
+}
+
+namespace Minecraft::Assets {
+	class ImageCache;
+
+	/// copies 'data' into a texture, through the stream buffer as pixel unpack buffer when given and it has room
+	/// 'target' is GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY, the z of 'offset' and 'size' are ignored for 2d textures
+	/// returns true if the upload was staged through the stream buffer
+	bool uploadPixels(GLuint texture, GLenum target, GLint level, glm::ivec3 offset, glm::ivec3 size, const uint8_t* data, Render::StreamBuffer* stream);
+
+	struct TextureLoaderStats {
+		/// loads that haven't been uploaded yet
+		size_t pending = 0;
+		uint64_t loaded = 0;
+		uint64_t failed = 0;
+		/// summed over the workers, so it can be more than the time the loads took
+		std::chrono::nanoseconds decodeTime = {};
+		uint64_t bytesUploaded = 0;
+	};
+
+	/// loads textures without blocking the thread owning the GL context
+	/// files are mapped instead of read, decoded (and mipmapped) on the workers, and only the upload happens on the main thread
+	/// a load returns a placeholder right away, which gets its actual contents once the upload has happened
+	/// the uploads are queued with 'JobSystem::submitToMainThread', so they happen in 'JobSystem::runMainThreadJobs'
+	class TextureLoader {
+	public:
+		struct ArraySource {
+			std::string name;
+			std::filesystem::path path;
+			/// cuts the image in tiles of the size of the array, named 'name:index' in reading order
+			bool split = false;
+		};
+
+		TextureLoader(Jobs::JobSystem& jobs, Render::StreamBuffer& stream, ImageCache* cache = nullptr);
+
+		TextureLoader(const TextureLoader&) = delete;
+		TextureLoader& operator=(const TextureLoader&) = delete;
+
+		/// paths are resolved like 'Texture2D::load'
+		/// the placeholder stays as is when the load fails
+		[[nodiscard]] std::shared_ptr<Texture2D> load(std::filesystem::path path);
+		/// every source is decoded and mipmapped on its own worker, and the array is uploaded once all are done
+		/// sources that fail to load are left out of the array
+		[[nodiscard]] std::shared_ptr<TextureArray> loadArray(std::vector<ArraySource> sources, glm::ivec2 size);
+
+		TextureLoaderStats getStats() const;
+
+	private:
+		/// shared with the jobs, so a load finishing after the loader is gone doesn't touch freed memory
+		/// the jobs refer to the job system, stream buffer and cache directly, which have to outlive the workers
+		struct State {
+			std::atomic<size_t> pending = 0;
+			std::atomic<uint64_t> loaded = 0;
+			std::atomic<uint64_t> failed = 0;
+			std::atomic<int64_t> decodeNanoseconds = 0;
+			std::atomic<uint64_t> bytesUploaded = 0;
+		};
+
+		Jobs::JobSystem& jobs;
+		Render::StreamBuffer& stream;
+		ImageCache* cache = nullptr;
+
+		std::shared_ptr<State> state = std::make_shared<State>();
+	};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Minecraft::Profiling {
+	struct TraceRecorderStats {
+		uint64_t written = 0;
+		/// events that didn't fit in the buffer of their thread before the writer got to it
+		uint64_t dropped = 0;
+	};
+
+	/// writes profiling zones, counters and frames to a chrome trace event json file, which perfetto can open
+	/// every thread records into its own ring buffer without locking, and a writer thread moves those to the file
+	/// the zones of 'Profiler' are recorded while this is recording, even when the profiler itself is disabled
+	class TraceRecorder {
+	public:
+		/// tracks that aren't a thread, see 'Profiler::getThreadNames' for the rest
+		static constexpr uint16_t GPU_TRACK = UINT16_MAX;
+		static constexpr uint16_t FRAME_TRACK = UINT16_MAX - 1;
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+		~TraceRecorder();
+
+		static TraceRecorder& get();
+
+		/// stops the recording that is still going first, returns false if the file can't be opened
+		bool start(const std::filesystem::path& path);
+		/// writes everything that was recorded and closes the file
+		void stop();
+		bool isRecording() const;
+
+		/// times are nanoseconds on the steady clock, see 'Profiler::now'
+		void recordZone(const char* name, int64_t start, int64_t end, uint16_t track);
+		/// a value over time, shown as a graph, infinity and nan are skipped
+		void recordCounter(const char* name, double value);
+
+		TraceRecorderStats getStats() const;
+
+	private:
+		TraceRecorder() = default;
+
+		enum class Type : uint8_t {
+			ZONE,
+			COUNTER,
+		};
+
+		struct Event {
+			/// has to outlive the recording, usually a string literal
+			const char* name = nullptr;
+			int64_t start = 0;
+			int64_t end = 0;
+			double value = 0;
+			uint16_t track = 0;
+			Type type = Type::ZONE;
+		};
+
+		/// single producer, single consumer, written by its thread and read by the writer
+		struct Ring {
+			static constexpr size_t CAPACITY = 8192;
+
+			std::array<Event, CAPACITY> events;
+			std::atomic<uint64_t> head = 0;
+			std::atomic<uint64_t> tail = 0;
+		};
+
+		Ring& getRing();
+		void push(const Event& event);
+
+		void run();
+		/// moves the events of every ring to the file, only called by the writer thread or once it has stopped
+		void drain();
+		void write(const Event& event);
+
+		std::atomic<bool> recording = false;
+		int64_t recordingStart = 0;
+
+		std::mutex ringsMutex;
+		std::vector<std::shared_ptr<Ring>> rings;
+
+		std::ofstream out;
+		bool isFirstEvent = true;
+
+		std::thread writer;
+		std::mutex writerMutex;
+		std::condition_variable writerWakeUp;
+
+		std::atomic<uint64_t> written = 0;
+		std::atomic<uint64_t> dropped = 0;
+	};
+}
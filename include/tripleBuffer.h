@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Minecraft::Jobs {
+	/// hands the newest value of one writing thread to one reading thread, without either of them ever waiting
+	/// the writer fills the back slot and swaps it with the middle one, the reader swaps the middle slot with the front one when it's newer
+	/// values the reader doesn't get to before the next one is published are skipped
+	template<typename T>
+	class TripleBuffer {
+	public:
+		TripleBuffer(const T& initial = {}) {
+			for (Slot& slot : slots)
+				slot.value = initial;
+		}
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		/// only used by the writer, the value is kept until it's overwritten so it can be updated in place
+		T& getBack() { return slots[back].value; }
+		/// makes the back slot available to the reader
+		void publish() {
+			back = middle.exchange(back | NEW, std::memory_order_acq_rel) & INDEX;
+		}
+
+		/// only used by the reader, returns true if a value was published since the last update
+		bool update() {
+			if (!(middle.load(std::memory_order_relaxed) & NEW))
+				return false;
+
+			front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+			return true;
+		}
+		/// the newest value as of the last 'update'
+		const T& getFront() const { return slots[front].value; }
+
+	private:
+		/// set in 'middle' when the writer swapped in a slot the reader hasn't seen yet
+		static constexpr uint8_t NEW = 4;
+		static constexpr uint8_t INDEX = 3;
+
+		/// on its own cache line, so the reader and writer don't slow each other down
+		struct alignas(64) Slot {
+			T value;
+		};
+
+		std::array<Slot, 3> slots = {};
+
+		uint8_t back = 0;
+		alignas(64) std::atomic<uint8_t> middle = 1;
+		alignas(64) uint8_t front = 2;
+	};
+}
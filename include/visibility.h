@@ -0,0 +1,65 @@
+#pragma once
+
+#include "chunk.h"
+#include "block.h"
+#include "frustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Minecraft::World {
+	/// which faces of a section can see each other through its non-opaque blocks
+	class Visibility {
+	public:
+		/// every face connected to every other, which is what an empty section is
+		Visibility() = default;
+
+		/// flood fills the non-opaque blocks of the section, faces touched by the same fill are connected
+		[[nodiscard]] static Visibility compute(const ChunkSection& section);
+		[[nodiscard]] static Visibility closed();
+
+		bool isConnected(Face a, Face b) const;
+		void connect(Face a, Face b);
+
+	private:
+		static constexpr uint64_t bit(Face a, Face b) { return uint64_t(1) << (static_cast<int>(a) * FACE_COUNT + static_cast<int>(b)); }
+
+		/// 6x6 symmetric matrix, bit 'a * 6 + b' is set when face a and face b are connected
+		uint64_t connections = (uint64_t(1) << (FACE_COUNT * FACE_COUNT)) - 1;
+	};
+
+	/// connectivity of the meshed sections, used to find the sections that can be seen from the camera
+	/// a section is only entered through a face that is connected to the face it's left through,
+	/// and the search never turns back towards the camera, so sections behind solid terrain aren't reached
+	class VisibilityGraph {
+	public:
+		void set(glm::ivec3 sectionPosition, Visibility visibility);
+		void remove(glm::ivec2 chunkPosition);
+		bool contains(glm::ivec3 sectionPosition) const;
+
+		/// breadth first search from the section the camera is in, only through sections inside the frustum if there is one
+		/// the result is valid until the next search
+		const std::vector<glm::ivec3>& findVisible(glm::ivec3 start, const Render::Frustum* frustum = nullptr);
+
+		size_t getSectionCount() const;
+
+	private:
+		struct Node {
+			glm::ivec3 position;
+			/// face the section was entered through
+			Face entry;
+			/// bit per face, set for the directions the search went in to get here
+			uint8_t directions;
+		};
+
+		std::unordered_map<glm::ivec3, Visibility, SectionPositionHash> sections = {};
+
+		std::vector<glm::ivec3> visible = {};
+		std::vector<Node> queue = {};
+		std::unordered_set<glm::ivec3, SectionPositionHash> visited = {};
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "chunk.h"
+#include "terrainGenerator.h"
+#include "regionFile.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace Minecraft::World {
+	/// owns the loaded chunks, only meant to be used from the main thread
+	/// chunks are shared, so jobs can keep using a chunk that has been unloaded in the meantime
+	class World {
+	public:
+		/// chunks are saved to and loaded from region files in 'directory'
+		World(uint32_t seed, std::filesystem::path directory);
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		std::shared_ptr<Chunk> getChunk(glm::ivec2 position) const;
+		bool hasChunk(glm::ivec2 position) const;
+		void setChunk(std::shared_ptr<Chunk> chunk);
+		void removeChunk(glm::ivec2 position);
+
+		/// nullptr when the chunk isn't loaded or the section is only air
+		const ChunkSection* getSection(glm::ivec3 sectionPosition) const;
+
+		BlockId getBlock(glm::ivec3 position) const;
+		BlockId setBlock(glm::ivec3 position, BlockId block);
+
+		size_t getChunkCount() const;
+		size_t getMemoryUsage() const;
+
+		const TerrainGenerator& getGenerator() const;
+		/// can be used from any thread
+		RegionStorage& getStorage();
+
+		static glm::ivec2 chunkPosition(glm::ivec3 position);
+		static glm::ivec3 sectionPosition(glm::ivec3 position);
+
+	private:
+		std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>, ChunkPositionHash> chunks = {};
+
+		TerrainGenerator generator;
+		RegionStorage storage;
+	};
+}
@@ -1,8 +1,30 @@
 #define GLM_ENABLE_EXPERIMENTAL
 
 #include "shader.h"
+#include "cameraBuffer.h"
 #include "renderObject.h"
 #include "texture.h"
+#include "chunk.h"
+#include "block.h"
+#include "mesher.h"
+#include "jobSystem.h"
+#include "world.h"
+#include "chunkLoader.h"
+#include "frustum.h"
+#include "visibility.h"
+#include "chunkRenderer.h"
+#include "streamBuffer.h"
+#include "glDebug.h"
+#include "renderState.h"
+#include "textureArray.h"
+#include "textureLoader.h"
+#include "imageCache.h"
+#include "programBinaryCache.h"
+#include "cameraPath.h"
+#include "framebuffer.h"
+#include "profiler.h"
+#include "traceRecorder.h"
+#include "simulation.h"
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -16,28 +38,107 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <chrono>
 #include <format>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <random>
 
 GLFWwindow* window = nullptr;
 GLFWcursor* cursor = nullptr;
 
-void init() {
+struct BenchmarkOptions {
+	std::filesystem::path cameraPath = "assets/paths/flyover.path";
+	std::filesystem::path output = "benchmark.csv";
+	glm::ivec2 size = { 1280, 720 };
+};
+
+struct Arguments {
+	/// nothing when the game should start normally
+	std::optional<BenchmarkOptions> benchmark;
+	/// records a trace from the start, see 'TraceRecorder'
+	std::optional<std::filesystem::path> trace;
+};
+
+/// 'minecraft [--benchmark [camera path] [--output file.csv] [--size 1280x720]] [--trace file.json]'
+Arguments parseArguments(int argc, char** argv) {
+	Arguments arguments;
+	BenchmarkOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc && !std::string_view(argv[i + 1]).starts_with("--");
+
+		if (argument == "--benchmark") {
+			arguments.benchmark = options;
+			if (hasValue)
+				arguments.benchmark->cameraPath = argv[++i];
+		} else if (argument == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else if (argument == "--size" && hasValue) {
+			glm::ivec2 size;
+			if (std::sscanf(argv[++i], "%dx%d", &size.x, &size.y) == 2 && size.x > 0 && size.y > 0)
+				options.size = size;
+			else
+				std::cerr << "size '" << argv[i] << "' should look like 1280x720" << std::endl;
+		} else if (argument == "--trace") {
+			arguments.trace = hasValue ? argv[++i] : "trace.json";
+		} else
+			std::cerr << "unknown argument '" << argument << "'" << std::endl;
+	}
+
+	// options can come before or after '--benchmark'
+	if (arguments.benchmark) {
+		arguments.benchmark->output = options.output;
+		arguments.benchmark->size = options.size;
+	}
+
+	return arguments;
+}
+
+/// a headless run has a hidden window without vsync, and no imgui
+void init(bool headless) {
 	//std::atexit([]() { std::cin.get(); });
 
 	glfwSetErrorCallback([](int error, const char* description) {
 		std::cerr << std::format("GLFW Error {}: {}", error, description) << std::endl;
 	});
 
+#ifdef GLFW_PLATFORM_NULL
+	// without a display server there is no window system to create a context with, the null platform uses egl directly
+	if (headless && !glfwInit())
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
 	if (!glfwInit())
 		exit(-1);
 
 	std::atexit(glfwTerminate);
 
+#ifdef GLFW_PLATFORM_NULL
+	// window hints are reset by 'glfwInit', and can only be set once it succeeded
+	if (glfwGetPlatform() == GLFW_PLATFORM_NULL)
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef MINECRAFT_GL_DEBUG
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+	if (headless)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 	window = glfwCreateWindow(1080, 720, "Minecraft", nullptr, nullptr);
 	if (window == nullptr)
@@ -45,7 +146,7 @@ void init() {
 
 	std::atexit([]() { glfwDestroyWindow(window); });
 	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1);
+	glfwSwapInterval(headless ? 0 : 1);
 
 	{
 		GLenum err = glewInit();
@@ -54,6 +155,16 @@ void init() {
 			exit(-1);
 		}
 	}
+	Minecraft::Render::enableDebugOutput();
+
+	// lets the driver compile shaders on its own threads, so a hot reload doesn't stall the frame it happens in
+	if (GLEW_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	else if (GLEW_KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
+	if (headless)
+		return;
 
 	glfwSetFramebufferSizeCallback(window, [](GLFWwindow* window, int width, int height) {
 		glViewport(0, 0, width, height);
@@ -102,15 +213,14 @@ void init() {
 }
 
 void renderOpenGLConfigMenu() {
+	Minecraft::Render::RenderState& state = Minecraft::Render::RenderState::get();
+
 	ImGui::Begin("OpenGL modes");
-	auto openGLToggle = [](GLenum flag, const char* name) {
-		bool isActive = glIsEnabled(flag);
+	auto openGLToggle = [&state](GLenum flag, const char* name) {
+		bool isActive = state.isEnabled(flag);
 
 		if (ImGui::Checkbox(name, &isActive))
-			if (!isActive) // already toggled, so use inverse
-				glDisable(flag);
-			else
-				glEnable(flag);
+			state.setEnabled(flag, isActive); // already toggled
 
 		return isActive; // might be toggled already, but is ok because feature is enabled/disabled already then
 	};
@@ -126,8 +236,7 @@ void renderOpenGLConfigMenu() {
 		const char* names[] = { "false", "a < b", "a == b", "a <= b", "a > b", "a != b", "a >= b", "true", };
 		GLenum values[] = { GL_NEVER, GL_LESS, GL_EQUAL, GL_LEQUAL, GL_GREATER, GL_NOTEQUAL, GL_GEQUAL, GL_ALWAYS, };
 
-		int value = 0;
-		glGetIntegerv(GL_DEPTH_FUNC, &value);
+		int value = state.getDepthFunc();
 		for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
 			if (value == values[i])
 				value = i;
@@ -138,7 +247,7 @@ void renderOpenGLConfigMenu() {
 				const bool is_selected = value == i;
 				if (ImGui::Selectable(names[i], is_selected)) {
 					value = i;
-					glDepthFunc(values[i]);
+					state.setDepthFunc(values[i]);
 				}
 
 				if (is_selected)
@@ -182,14 +291,11 @@ void renderOpenGLConfigMenu() {
 			}
 			return update;
 		};
-		int srcRGB = 0;
-		int srcA = 0;
-		int dstRGB = 0;
-		int dstA = 0;
-		glGetIntegerv(GL_BLEND_SRC_RGB, &srcRGB);
-		glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcA);
-		glGetIntegerv(GL_BLEND_DST_RGB, &dstRGB);
-		glGetIntegerv(GL_BLEND_DST_ALPHA, &dstA);
+		Minecraft::Render::BlendFunc blendFunc = state.getBlendFunc();
+		int srcRGB = blendFunc.sourceRGB;
+		int srcA = blendFunc.sourceAlpha;
+		int dstRGB = blendFunc.destinationRGB;
+		int dstA = blendFunc.destinationAlpha;
 		for (size_t i = 0; i < sizeof(funcValues) / sizeof(funcValues[0]); i++) {
 			if (srcRGB == funcValues[i]) srcRGB = i;
 			if (srcA   == funcValues[i]) srcA   = i;
@@ -219,10 +325,9 @@ void renderOpenGLConfigMenu() {
 			}
 			return update;
 		};
-		int equationRGB = 0;
-		int equationA = 0;
-		glGetIntegerv(GL_BLEND_EQUATION_RGB, &equationRGB);
-		glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &equationA);
+		Minecraft::Render::BlendEquation blendEquation = state.getBlendEquation();
+		int equationRGB = blendEquation.rgb;
+		int equationA = blendEquation.alpha;
 		for (size_t i = 0; i < sizeof(equationValues) / sizeof(equationValues[0]); i++) {
 			if (equationRGB == equationValues[i]) equationRGB = i;
 			if (equationA   == equationValues[i]) equationA   = i;
@@ -241,11 +346,10 @@ void renderOpenGLConfigMenu() {
 		if (useSeperate) funcUpdate |= funcCombo("blend dest alpha", dstA);
 
 		if (srcRGB >= 10 || srcA >= 10 || dstRGB >= 10 || dstA >= 10) {
-			glm::vec4 color(0, 0, 0, 1);
-			glGetFloatv(GL_BLEND_COLOR, glm::value_ptr(color));
+			glm::vec4 color = state.getBlendColor();
 
 			if (ImGui::ColorEdit4("blend color", glm::value_ptr(color)))
-				glBlendColor(color.r, color.g, color.b, color.a);
+				state.setBlendColor(color);
 		}
 
 		equationUpdate |= equationCombo("blend equation", equationRGB);
@@ -254,15 +358,15 @@ void renderOpenGLConfigMenu() {
 
 		if (funcUpdate) {
 			if (useSeperate)
-				glBlendFuncSeparate(funcValues[srcRGB], funcValues[dstRGB], funcValues[srcA], funcValues[dstA]);
+				state.setBlendFunc({ funcValues[srcRGB], funcValues[dstRGB], funcValues[srcA], funcValues[dstA] });
 			else
-				glBlendFunc(funcValues[srcRGB], funcValues[dstRGB]);
+				state.setBlendFunc({ funcValues[srcRGB], funcValues[dstRGB], funcValues[srcRGB], funcValues[dstRGB] });
 		}
 		if (equationUpdate) {
 			if (useSeperate)
-				glBlendEquationSeparate(equationValues[equationRGB], equationValues[equationA]);
+				state.setBlendEquation({ equationValues[equationRGB], equationValues[equationA] });
 			else
-				glBlendEquation(equationValues[equationRGB]);
+				state.setBlendEquation({ equationValues[equationRGB], equationValues[equationRGB] });
 		}
 	}
 
@@ -282,7 +386,7 @@ void renderOpenGLConfigMenu() {
 			ImGui::Unindent();
 
 			if (update)
-				glCullFace(values[value]);
+				state.setCullFace(values[value]);
 		}
 		{
 			const char* names[] = { "clockwise", "counterclockwise", };
@@ -299,7 +403,7 @@ void renderOpenGLConfigMenu() {
 			ImGui::Unindent();
 
 			if (update)
-				glFrontFace(values[value]);
+				state.setFrontFace(values[value]);
 		}
 	}
 
@@ -316,33 +420,39 @@ void renderOpenGLConfigMenu() {
 		}
 
 		if (update)
-			glPolygonMode(GL_FRONT_AND_BACK, values[value]);
+			state.setPolygonMode(values[value]);
 
 		ImGui::Indent();
 		switch (values[value]) {
 		case GL_POINT: {
-			float range[] = { 1, 1 };
-			float currentSize = 1;
-
-			glGetFloatv(GL_POINT_SIZE_RANGE, range);
-			glGetFloatv(GL_POINT_SIZE, &currentSize);
+			// limits of the driver, they don't change
+			static glm::vec2 range = [] {
+				glm::vec2 range(1);
+				glGetFloatv(GL_POINT_SIZE_RANGE, glm::value_ptr(range));
+				return range;
+			}();
+			float currentSize = state.getPointSize();
 
 			if (ImGui::SliderFloat("Point size", &currentSize, range[0], range[1], nullptr, ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp))
-				glPointSize(glm::clamp(currentSize, range[0], range[1]));
+				state.setPointSize(glm::clamp(currentSize, range[0], range[1]));
 		} break;
 		case GL_LINE: {
-			bool isSmooth = glIsEnabled(GL_LINE_SMOOTH);
-			float range[] = { 1, 1 };
-			float currentSize = 1;
-
-			glGetFloatv(isSmooth ? GL_SMOOTH_LINE_WIDTH_RANGE : GL_ALIASED_LINE_WIDTH_RANGE, range);
-			glGetFloatv(GL_LINE_WIDTH, &currentSize);
+			bool isSmooth = state.isEnabled(GL_LINE_SMOOTH);
+			auto getRange = [](GLenum name) {
+				glm::vec2 range(1);
+				glGetFloatv(name, glm::value_ptr(range));
+				return range;
+			};
+			static glm::vec2 smoothRange = getRange(GL_SMOOTH_LINE_WIDTH_RANGE);
+			static glm::vec2 aliasedRange = getRange(GL_ALIASED_LINE_WIDTH_RANGE);
+			glm::vec2 range = isSmooth ? smoothRange : aliasedRange;
+			float currentSize = state.getLineWidth();
 
 			bool isChanged = ImGui::SliderFloat("line width", &currentSize, range[0], range[1], nullptr, ImGuiSliderFlags_AlwaysClamp);
 			isChanged |= openGLToggle(GL_LINE_SMOOTH, "use smooth lines") == isSmooth;
 
 			if (isChanged)
-				glLineWidth(glm::clamp(currentSize, range[0], range[1]));
+				state.setLineWidth(glm::clamp(currentSize, range[0], range[1]));
 
 		} break;
 		}
@@ -352,6 +462,166 @@ void renderOpenGLConfigMenu() {
 	ImGui::End();
 }
 
+ImU32 zoneColor(const char* name) {
+	// by name, so a zone keeps its color between frames
+	size_t hash = std::hash<std::string_view>()(name);
+	return ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.75f);
+}
+
+/// draws the zones as bars on a timeline from 'start' to 'end', nested zones below the zone they're in
+void renderProfilerTimeline(const char* label, const std::vector<Minecraft::Profiling::Zone>& zones, int64_t start, int64_t end) {
+	if (zones.empty())
+		return;
+
+	uint16_t maxDepth = 0;
+	for (const Minecraft::Profiling::Zone& zone : zones)
+		maxDepth = std::max(maxDepth, zone.depth);
+
+	ImGui::TextUnformatted(label);
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	float width = ImGui::GetContentRegionAvail().x;
+	float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	double scale = width / double(std::max<int64_t>(end - start, 1));
+
+	for (const Minecraft::Profiling::Zone& zone : zones) {
+		// zones on other threads can start before or end after the frame
+		float x0 = origin.x + std::clamp(float((zone.start - start) * scale), 0.0f, width);
+		float x1 = origin.x + std::clamp(float((zone.end - start) * scale), 0.0f, width);
+		x1 = std::max(x1, x0 + 1);
+		float y0 = origin.y + zone.depth * rowHeight;
+
+		ImVec2 min(x0, y0);
+		ImVec2 max(x1, y0 + rowHeight - 1);
+		drawList->AddRectFilled(min, max, zoneColor(zone.name));
+		if (x1 - x0 > ImGui::CalcTextSize(zone.name).x) {
+			drawList->PushClipRect(min, max, true);
+			drawList->AddText({ x0 + 2, y0 }, IM_COL32_BLACK, zone.name);
+			drawList->PopClipRect();
+		}
+
+		if (ImGui::IsMouseHoveringRect(min, max))
+			ImGui::SetTooltip("%s: %.3f ms", zone.name, (zone.end - zone.start) / 1e6);
+	}
+
+	ImGui::Dummy({ width, (maxDepth + 1) * rowHeight });
+}
+
+void renderProfilerWindow() {
+	Minecraft::Profiling::Profiler& profiler = Minecraft::Profiling::Profiler::get();
+
+	if (!ImGui::Begin("profiler")) {
+		ImGui::End();
+		return;
+	}
+
+	bool isEnabled = profiler.isEnabled();
+	if (ImGui::Checkbox("enabled", &isEnabled))
+		profiler.setEnabled(isEnabled);
+	ImGui::SameLine();
+	static bool isPaused = false;
+	ImGui::Checkbox("pause", &isPaused);
+
+	Minecraft::Profiling::TraceRecorder& recorder = Minecraft::Profiling::TraceRecorder::get();
+	static char tracePath[256] = "trace.json";
+	ImGui::BeginDisabled(recorder.isRecording());
+	ImGui::InputText("##trace path", tracePath, sizeof(tracePath));
+	ImGui::EndDisabled();
+	ImGui::SameLine();
+	if (!recorder.isRecording()) {
+		if (ImGui::Button("record trace"))
+			recorder.start(tracePath);
+	} else if (ImGui::Button("stop"))
+		recorder.stop();
+	Minecraft::Profiling::TraceRecorderStats traceStats = recorder.getStats();
+	ImGui::Text("trace: %llu events written, %llu dropped", (unsigned long long) traceStats.written, (unsigned long long) traceStats.dropped);
+
+	const std::deque<Minecraft::Profiling::FrameProfile>& frames = profiler.getFrames();
+
+	// copies, so the graph and the selected frame stay put while paused
+	static std::vector<float> durations;
+	static std::vector<uint64_t> indices;
+	static Minecraft::Profiling::FrameProfile selected;
+	if (!isPaused) {
+		durations.clear();
+		indices.clear();
+		for (const Minecraft::Profiling::FrameProfile& frame : frames) {
+			durations.push_back((frame.end - frame.start) / 1e6f);
+			indices.push_back(frame.index);
+		}
+
+		// the newest frame that has all its gpu zones
+		for (auto it = frames.rbegin(); it != frames.rend(); it++) {
+			if (it->isGpuComplete) {
+				selected = *it;
+				break;
+			}
+		}
+	}
+
+	ImGui::PlotHistogram("##frame times", durations.data(), durations.size(), 0, "frame time, click to select while paused", 0, 1000 / 30.0f, { -FLT_MIN, 60 });
+	if (isPaused && ImGui::IsItemClicked() && !durations.empty()) {
+		float x = (ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+		uint64_t index = indices[std::clamp<size_t>(x * durations.size(), 0, durations.size() - 1)];
+		// only frames that are still in the history can be shown
+		if (auto it = std::ranges::find(frames, index, &Minecraft::Profiling::FrameProfile::index); it != frames.end())
+			selected = *it;
+	}
+
+	ImGui::Text("frame %llu: %.3f ms", (unsigned long long) selected.index, (selected.end - selected.start) / 1e6);
+
+	std::vector<std::string> threadNames = profiler.getThreadNames();
+	for (size_t thread = 0; thread < threadNames.size(); thread++) {
+		std::vector<Minecraft::Profiling::Zone> zones;
+		std::ranges::copy_if(selected.cpuZones, std::back_inserter(zones), [thread](const Minecraft::Profiling::Zone& zone) { return zone.thread == thread; });
+		renderProfilerTimeline(threadNames[thread].c_str(), zones, selected.start, selected.end);
+	}
+	renderProfilerTimeline("gpu", selected.gpuZones, selected.start, selected.end);
+
+	if (ImGui::TreeNode("totals")) {
+		struct Total {
+			std::string name;
+			size_t count = 0;
+			double milliseconds = 0;
+		};
+		std::vector<Total> totals;
+		auto add = [&totals](std::string name, const Minecraft::Profiling::Zone& zone) {
+			auto it = std::ranges::find(totals, name, &Total::name);
+			if (it == totals.end())
+				it = totals.insert(totals.end(), { std::move(name) });
+			it->count++;
+			it->milliseconds += (zone.end - zone.start) / 1e6;
+		};
+		for (const Minecraft::Profiling::Zone& zone : selected.cpuZones)
+			add(std::format("{} ({})", zone.name, zone.thread < threadNames.size() ? threadNames[zone.thread] : "?"), zone);
+		for (const Minecraft::Profiling::Zone& zone : selected.gpuZones)
+			add(std::format("{} (gpu)", zone.name), zone);
+		std::ranges::sort(totals, std::greater(), &Total::milliseconds);
+
+		if (ImGui::BeginTable("totals", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+			ImGui::TableSetupColumn("zone");
+			ImGui::TableSetupColumn("count");
+			ImGui::TableSetupColumn("ms");
+			ImGui::TableHeadersRow();
+			for (const Total& total : totals) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(total.name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%zu", total.count);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", total.milliseconds);
+			}
+			ImGui::EndTable();
+		}
+
+		ImGui::TreePop();
+	}
+
+	ImGui::End();
+}
+
 Minecraft::Assets::VAO createCube(uint8_t atlasIndex) {
 	static const glm::vec3 vertices[] = {
 		// back
@@ -500,8 +770,24 @@ Minecraft::Assets::VAO createCube(uint8_t atlasIndex) {
 	);
 }
 
-int main() {
-	init();
+Minecraft::Render::AABB sectionBounds(glm::ivec3 sectionPosition, const Minecraft::World::ChunkMesh& mesh) {
+	glm::vec3 origin(sectionPosition * Minecraft::World::ChunkSection::SIZE);
+
+	return { origin + glm::vec3(mesh.min), origin + glm::vec3(mesh.max) };
+}
+
+int main(int argc, char** argv) {
+	Minecraft::Profiling::Profiler::get().setThreadName("main");
+
+	auto [benchmark, trace] = parseArguments(argc, argv);
+	init(benchmark.has_value());
+
+	if (trace)
+		Minecraft::Profiling::TraceRecorder::get().start(*trace);
+
+	Minecraft::World::BlockRegistry::registerDefaults();
+
+	std::shared_ptr<Minecraft::Assets::ProgramBinaryCache> programCache = std::make_shared<Minecraft::Assets::ProgramBinaryCache>("cache/shaders");
 
 	std::shared_ptr<Minecraft::Assets::Shader::Program> program = Minecraft::Assets::Shader::Program::create();
 	program
@@ -510,51 +796,299 @@ int main() {
 		->bindAttribute(0, "a_position")
 		->bindAttribute(1, "a_color")
 		->bindAttribute(2, "a_texcoord")
+		->useBinaryCache(programCache)
 		->link()
 		->use();
 
-	std::shared_ptr<Minecraft::Assets::Texture2D> img = Minecraft::Assets::Texture2D::load(std::filesystem::path("blocks.png"));
-	img->bind();
-
-	ImGuiIO& io = ImGui::GetIO();
+	std::shared_ptr<Minecraft::Assets::Shader::Program> chunkProgram = Minecraft::Assets::Shader::Program::create();
+	chunkProgram
+		->attachShader(Minecraft::Assets::Shader::parse(std::filesystem::path("chunk"), GL_VERTEX_SHADER))
+		->attachShader(Minecraft::Assets::Shader::parse(std::filesystem::path("chunk"), GL_FRAGMENT_SHADER))
+		->bindAttribute(0, "a_data")
+		->useBinaryCache(programCache)
+		->link();
 
 	glm::vec3 bgCol(0.9, 0.9, 1.0f);
 
 	glm::mat4 model = glm::mat4(1);
 	glm::mat4 view = glm::mat4(1);
-	glm::mat4 proj = glm::perspective(45.0f, 1080 / 720.0f, 0.1f, 100.0f);
+	glm::vec3 cameraPosition(0);
+	glm::mat4 proj = glm::perspective(45.0f, 1080 / 720.0f, 0.1f, 1000.0f);
 
 	program->setUniform("modelMatrix", model);
-	program->setUniform("viewMatrix", view);
-	program->setUniform("projectionMatrix", proj);
+
+	Minecraft::Assets::CameraBuffer camera;
+	camera.update(view, proj, cameraPosition);
 
 	Minecraft::Assets::VAO cube1 = createCube(0);
 	Minecraft::Assets::VAO cube2 = createCube(1);
 
-	glEnable(GL_DEPTH_TEST);
+	struct SectionMesh {
+		size_t quadCount;
+		size_t faceCount;
+		Minecraft::Render::AABB bounds;
+	};
+	std::unordered_map<glm::ivec3, SectionMesh, Minecraft::World::SectionPositionHash> sectionMeshes;
+	Minecraft::World::VisibilityGraph visibilityGraph;
+	Minecraft::Render::StreamBuffer streamBuffer;
+	Minecraft::Render::ChunkRenderer chunkRenderer(streamBuffer);
 
-	glDisable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	Minecraft::Assets::ImageCache imageCache("cache/textures");
 
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
-	glFrontFace(GL_CCW);
+	// declared after everything the jobs refer to, so the workers are joined before those are destroyed
+	Minecraft::Jobs::JobSystem jobs;
 
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	// both start out as placeholders, and are filled in by 'runMainThreadJobs' once decoded
+	Minecraft::Assets::TextureLoader textureLoader(jobs, streamBuffer, &imageCache);
+	std::shared_ptr<Minecraft::Assets::Texture2D> img = textureLoader.load(std::filesystem::path("blocks.png"));
+	std::shared_ptr<Minecraft::Assets::TextureArray> blockTextures;
+	{
+		// blocks refer to the tiles of 'blocks.png' by index, so those are the first layers
+		std::vector<Minecraft::Assets::TextureLoader::ArraySource> sources = { { "blocks.png", "assets/textures/blocks.png", true } };
+		for (const auto& [name, path] : Minecraft::Assets::TextureArray::find("assets/textures/block"))
+			sources.push_back({ name, path });
 
-	while (!glfwWindowShouldClose(window)) {
-		if (program->update()) {
-			program->setUniform("modelMatrix", model);
-			program->setUniform("viewMatrix", view);
-			program->setUniform("projectionMatrix", proj);
+		blockTextures = textureLoader.loadArray(std::move(sources), { 16, 16 });
+	}
+	Minecraft::World::World world(1337, "saves/world");
+	Minecraft::World::ChunkLoader chunkLoader(world, jobs, 6);
+
+	// only the upload needs the GL context, generating and meshing happens on the workers
+	chunkLoader.onMeshed([&sectionMeshes, &visibilityGraph, &chunkRenderer](glm::ivec3 position, Minecraft::World::ChunkMesh&& mesh) {
+		visibilityGraph.set(position, mesh.visibility);
+		chunkRenderer.upload(position, mesh);
+
+		if (mesh.isEmpty())
+			sectionMeshes.erase(position);
+		else
+			sectionMeshes.insert_or_assign(position, SectionMesh{ mesh.getQuadCount(), mesh.faceCount, sectionBounds(position, mesh) });
+	});
+	chunkLoader.onUnloaded([&sectionMeshes, &visibilityGraph, &chunkRenderer](glm::ivec2 position) {
+		visibilityGraph.remove(position);
+		for (int y = 0; y < Minecraft::World::Chunk::SECTION_COUNT; y++) {
+			chunkRenderer.remove({ position.x, y, position.y });
+			sectionMeshes.erase({ position.x, y, position.y });
+		}
+	});
+
+	Minecraft::Render::RenderState& renderState = Minecraft::Render::RenderState::get();
+
+	renderState.setEnabled(GL_DEPTH_TEST, true);
+
+	renderState.setEnabled(GL_BLEND, false);
+	renderState.setBlendFunc({ GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA });
+
+	renderState.setEnabled(GL_CULL_FACE, true);
+	renderState.setCullFace(GL_BACK);
+	renderState.setFrontFace(GL_CCW);
+
+	renderState.setPolygonMode(GL_FILL);
+
+	struct WorldDrawStats {
+		size_t visibleCount = 0;
+		size_t reachableCount = 0;
+		size_t triangleCount = 0;
+		std::chrono::duration<double, std::micro> cullTime = {};
+	};
+	// shared by the debug menu and benchmark runs, draws with the current view and leaves the chunk program in use
+	auto drawWorld = [&](bool frustumCulling, bool caveCulling) {
+		WorldDrawStats stats;
+
+		static std::vector<Minecraft::Render::AABB> bounds;
+		static std::vector<glm::ivec3> sections;
+		static std::vector<uint8_t> visible;
+		static std::vector<glm::ivec3> drawn;
+		bounds.clear();
+		sections.clear();
+		drawn.clear();
+
+		{
+			Minecraft::Profiling::CpuZone zone("culling");
+			auto cullStart = std::chrono::steady_clock::now();
+			Minecraft::Render::Frustum frustum(proj * view);
+
+			// the search needs the section the camera is in, without it every section is a candidate
+			glm::ivec3 cameraSection = Minecraft::World::World::sectionPosition(glm::ivec3(glm::floor(cameraPosition)));
+			if (caveCulling && visibilityGraph.contains(cameraSection)) {
+				const std::vector<glm::ivec3>& reachable = visibilityGraph.findVisible(cameraSection, frustumCulling ? &frustum : nullptr);
+				stats.reachableCount = reachable.size();
+				for (glm::ivec3 position : reachable) {
+					if (auto it = sectionMeshes.find(position); it != sectionMeshes.end()) {
+						bounds.push_back(it->second.bounds);
+						sections.push_back(position);
+					}
+				}
+			} else {
+				for (const auto& [position, mesh] : sectionMeshes) {
+					bounds.push_back(mesh.bounds);
+					sections.push_back(position);
+				}
+			}
+			visible.assign(sections.size(), true);
+
+			stats.visibleCount = sections.size();
+			if (frustumCulling)
+				stats.visibleCount = frustum.cull(bounds, visible);
+			stats.cullTime = std::chrono::steady_clock::now() - cullStart;
+		}
+
+		for (size_t i = 0; i < sections.size(); i++) {
+			if (visible[i]) {
+				drawn.push_back(sections[i]);
+				stats.triangleCount += sectionMeshes.at(sections[i]).quadCount * 2;
+			}
 		}
 
-		glfwPollEvents();
+		Minecraft::Profiling::CpuZone drawZone("chunk draw");
+		Minecraft::Profiling::GpuZone gpuDrawZone("chunk draw");
+
+		chunkProgram->use();
+		// see 'chunk.frag'
+		blockTextures->bind(1);
+
+		chunkRenderer.draw(drawn);
+
+		return stats;
+	};
+
+	// once per frame, only does something while a trace is being recorded
+	auto recordCounters = [&](double frameMilliseconds) {
+		Minecraft::Profiling::TraceRecorder& recorder = Minecraft::Profiling::TraceRecorder::get();
+		if (!recorder.isRecording())
+			return;
+
+		recorder.recordCounter("frame ms", frameMilliseconds);
+		recorder.recordCounter("chunks loaded", world.getChunkCount());
+		recorder.recordCounter("chunks meshing", chunkLoader.getMeshingCount());
+		recorder.recordCounter("jobs pending", jobs.getPendingCount());
+		recorder.recordCounter("stream KiB", streamBuffer.getStats().bytesLastFrame / 1024.0);
+	};
+
+	if (benchmark) {
+		std::shared_ptr<Minecraft::Assets::CameraPath> cameraPath = Minecraft::Assets::CameraPath::load(benchmark->cameraPath);
+		if (!cameraPath)
+			return 1;
+
+		std::ofstream csv(benchmark->output);
+		if (!csv) {
+			std::cerr << "could not open '" << benchmark->output << "' to write the results to" << std::endl;
+			return 1;
+		}
+
+		// rendering to the window would tie the frames to the compositor, if there even is one
+		Minecraft::Assets::Framebuffer framebuffer(benchmark->size);
+		if (!framebuffer.isComplete())
+			return 1;
+		framebuffer.bind();
+		proj = glm::perspective(45.0f, benchmark->size.x / (float) benchmark->size.y, 0.1f, 1000.0f);
+
+		auto chunkCenter = [](glm::vec3 position) { return Minecraft::World::World::chunkPosition(glm::ivec3(glm::floor(position))); };
+
+		// without waiting for the world around the start of the path, the first frames would only measure generation
+		{
+			glm::ivec2 center = chunkCenter(cameraPath->sample(0).position);
+			auto warmupStart = std::chrono::steady_clock::now();
+			do {
+				// main thread jobs first, so meshing of chunks that just finished generating is queued before checking
+				jobs.runMainThreadJobs();
+				chunkLoader.update(center);
+				streamBuffer.endFrame();
+
+				if (std::chrono::steady_clock::now() - warmupStart > std::chrono::seconds(60)) {
+					std::cerr << "world didn't finish loading within a minute, starting the benchmark anyway" << std::endl;
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			} while (chunkLoader.getGeneratingCount() > 0 || chunkLoader.getLightingCount() > 0 || chunkLoader.getMeshingCount() > 0 || jobs.getMainThreadPendingCount() > 0 || !blockTextures->isLoaded());
+		}
+
+		csv << "frame,time,cpu_ms,frame_ms,draws,triangles\n";
+
+		// a fixed step instead of the time that passed, so every run renders the same frames
+		constexpr float FRAME_STEP = 1 / 60.0f;
+		size_t frameCount = size_t(cameraPath->getDuration() / FRAME_STEP) + 1;
+		std::chrono::duration<double, std::milli> totalTime = {};
+		for (size_t frame = 0; frame < frameCount; frame++) {
+			float time = frame * FRAME_STEP;
+			auto frameStart = std::chrono::steady_clock::now();
+			Minecraft::Profiling::Profiler::get().beginFrame();
+
+			cameraPosition = cameraPath->sample(time).position;
+			view = cameraPath->getView(time);
+			camera.update(view, proj, cameraPosition);
+
+			jobs.runMainThreadJobs(std::chrono::milliseconds(2));
+			chunkLoader.update(chunkCenter(cameraPosition));
+
+			glClearColor(bgCol.r, bgCol.g, bgCol.b, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			WorldDrawStats stats = drawWorld(true, true);
+
+			streamBuffer.endFrame();
+			std::chrono::duration<double, std::milli> cpuTime = std::chrono::steady_clock::now() - frameStart;
+
+			// there is no swap to throttle the cpu, and on a software renderer this is where the drawing happens
+			glFinish();
+			std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+			totalTime += frameTime;
+
+			Minecraft::Profiling::Profiler::get().endFrame();
+			recordCounters(frameTime.count());
+
+			csv << std::format("{},{:.4f},{:.4f},{:.4f},{},{}\n", frame, time, cpuTime.count(), frameTime.count(), chunkRenderer.getDrawCount(), stats.triangleCount);
+		}
+
+		std::cout << std::format("rendered {} frames at {}x{} in {:.1f} ms, {:.3f} ms per frame, written to '{}'",
+			frameCount, benchmark->size.x, benchmark->size.y, totalTime.count(), totalTime.count() / frameCount, benchmark->output.string()) << std::endl;
+
+		Minecraft::Profiling::TraceRecorder::get().stop();
+		return 0;
+	}
+
+	// only exists outside of benchmark runs
+	ImGuiIO& io = ImGui::GetIO();
+
+	// the game logic runs on its own thread, at a fixed rate
+	Minecraft::Game::GameState initialState;
+	initialState.target = { 0, Minecraft::World::TerrainGenerator::BASE_HEIGHT, 0 };
+	Minecraft::Game::Simulation simulation(initialState, 60);
+
+	Minecraft::Profiling::Profiler& profiler = Minecraft::Profiling::Profiler::get();
+
+	while (!glfwWindowShouldClose(window)) {
+		profiler.beginFrame();
+
+		{
+			Minecraft::Profiling::CpuZone zone("shader reload");
+			if (program->update())
+				program->setUniform("modelMatrix", model);
+			chunkProgram->update();
+		}
+		{
+			Minecraft::Profiling::CpuZone zone("chunk loader");
+			chunkLoader.update({ 0, 0 });
+		}
+		{
+			// mostly uploads of meshes and textures
+			Minecraft::Profiling::CpuZone zone("main thread jobs");
+			Minecraft::Profiling::GpuZone gpuZone("main thread jobs");
+			jobs.runMainThreadJobs(std::chrono::milliseconds(2));
+		}
+		{
+			Minecraft::Profiling::CpuZone zone("events");
+			glfwPollEvents();
+		}
 
 		double time = glfwGetTime();
 		static double pTime = time;
 
-		program->setUniform("time", (float) time);
+		// between the last two ticks, so the camera moves smoothly whatever the tick rate is
+		Minecraft::Game::GameState gameState = simulation.sample();
+		cameraPosition = gameState.getCameraPosition();
+		view = gameState.getView();
+		camera.update(view, proj, cameraPosition);
+
+		program->setUniform("time", (float) gameState.time);
 
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
@@ -574,6 +1108,13 @@ int main() {
 			ImGui::Checkbox("Render cube 1", &renderCube1);
 			ImGui::Checkbox("Render cube 2", &renderCube2);
 
+			Minecraft::Profiling::CpuZone zone("cubes");
+			Minecraft::Profiling::GpuZone gpuZone("cubes");
+
+			// the loader replaces the texture once it's uploaded, so it's bound every frame
+			if (renderCube1 || renderCube2)
+				img->bind();
+
 			if (renderCube1) {
 				model = glm::mat4(1);
 				if (renderCube2)
@@ -593,56 +1134,190 @@ int main() {
 				cube2.draw();
 			}
 		}
-		static float pitch = 0;
-		static float yaw = 0;
-		static float roll = 0;
-		static bool changedAngle = true;
-		ImGui::BeginGroup();
-		changedAngle |= ImGui::SliderAngle("pitch", &pitch, -90, 90);
-		changedAngle |= ImGui::SliderAngle("Yaw", &yaw);
-		changedAngle |= ImGui::SliderAngle("Roll", &roll);
-		ImGui::EndGroup();
-		ImGui::SameLine();
-		ImGui::BeginGroup();
-		ImGui::BeginDisabled(glm::abs(pitch) < 0.01);
-		if (ImGui::Button("reset##pitch", { -FLT_MIN, 0 })) {
-			pitch = 0;
-			changedAngle = true;
-		}
-		ImGui::EndDisabled();
-		ImGui::BeginDisabled(glm::abs(yaw) < 0.01);
-		if (ImGui::Button("reset##yaw", { -FLT_MIN, 0 })) {
-			yaw = 0;
-			changedAngle = true;
-		}
-		ImGui::EndDisabled();
-		ImGui::BeginDisabled(glm::abs(roll) < 0.01);
-		if (ImGui::Button("reset##roll", { -FLT_MIN, 0 })) {
-			roll = 0;
-			changedAngle = true;
-		}
-		ImGui::EndDisabled();
-		ImGui::EndGroup();
-		ImGui::BeginDisabled(glm::abs(pitch) < 0.01 && glm::abs(yaw) < 0.01 && glm::abs(roll) < 0.01);
-		if (ImGui::Button("reset", { -FLT_MIN, 0 })) {
-			pitch = 0;
-			yaw = 0;
-			roll = 0;
-			changedAngle = true;
-		}
-		ImGui::EndDisabled();
-		if (changedAngle) {
-			glm::mat4 rotation = glm::yawPitchRoll(yaw, pitch, roll);
-
-			view = glm::lookAt(glm::vec3(rotation * glm::vec4(0, 0, 3, 0)), glm::vec3(0), glm::vec3(rotation * glm::vec4(0, 1, 0, 0)));
-
-			program->setUniform("viewMatrix", view);
-
-			changedAngle = false;
+		{
+			static bool renderWorld = true;
+			static int viewDistance = chunkLoader.getViewDistance();
+
+			ImGui::Checkbox("Render world", &renderWorld);
+			if (ImGui::SliderInt("view distance", &viewDistance, 0, 32, nullptr, ImGuiSliderFlags_AlwaysClamp))
+				chunkLoader.setViewDistance(viewDistance);
+
+			size_t quadCount = 0;
+			size_t faceCount = 0;
+			for (const auto& [position, mesh] : sectionMeshes) {
+				quadCount += mesh.quadCount;
+				faceCount += mesh.faceCount;
+			}
+
+			ImGui::Text("chunks: %zu loaded, %zu generating, %zu meshing, %llu cancelled",
+				world.getChunkCount(), chunkLoader.getGeneratingCount(), chunkLoader.getMeshingCount(), (unsigned long long) chunkLoader.getCancelledCount());
+			ImGui::Text("world: %zu KiB, %zu quads for %zu faces", world.getMemoryUsage() / 1024, quadCount, faceCount);
+			ImGui::Text("generation: %.0f chunks/s per core", world.getGenerator().getThroughput());
+			ImGui::Text("storage: %llu loaded, %llu saved, %zu saving, %zu region files",
+				(unsigned long long) chunkLoader.getLoadedCount(), (unsigned long long) chunkLoader.getSavedCount(), chunkLoader.getSavingCount(), world.getStorage().getRegionCount());
+
+			if (ImGui::TreeNode("lighting")) {
+				// lights hovering a few blocks above the terrain, so their light spreads over the surface and into nearby caves
+				// removing them leaves air, which is what's above the terrain almost everywhere
+				static std::vector<glm::ivec3> placedLights;
+				static std::mt19937 random(std::random_device{}());
+				static int lightCount = 16;
+
+				ImGui::SliderInt("count", &lightCount, 1, 256, nullptr, ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp);
+				if (ImGui::Button("place glowstone")) {
+					Minecraft::World::BlockId glowstone = Minecraft::World::BlockRegistry::find("glowstone");
+					std::uniform_int_distribution<int> distribution(-2 * Minecraft::World::ChunkSection::SIZE, 2 * Minecraft::World::ChunkSection::SIZE - 1);
+
+					for (int i = 0; i < lightCount; i++) {
+						glm::ivec3 position(distribution(random), 0, distribution(random));
+						glm::ivec2 chunkPosition = Minecraft::World::World::chunkPosition(position);
+						glm::ivec2 local = glm::ivec2(position.x, position.z) - chunkPosition * Minecraft::World::ChunkSection::SIZE;
+						position.y = world.getGenerator().generateHeightmap(chunkPosition)[local.x + local.y * Minecraft::World::ChunkSection::SIZE] + 3;
+
+						if (chunkLoader.setBlock(position, glowstone))
+							placedLights.push_back(position);
+					}
+				}
+				ImGui::SameLine();
+				ImGui::BeginDisabled(placedLights.empty());
+				if (ImGui::Button("remove")) {
+					for (glm::ivec3 position : placedLights)
+						chunkLoader.setBlock(position, Minecraft::World::AIR);
+					placedLights.clear();
+				}
+				ImGui::EndDisabled();
+
+				uint64_t updateCount = chunkLoader.getLightUpdateCount();
+				double updateSeconds = std::chrono::duration<double>(chunkLoader.getLightUpdateTime()).count();
+				ImGui::Text("%zu placed, %zu chunks being lit", placedLights.size(), chunkLoader.getLightingCount());
+				ImGui::Text("%llu updates in %.2f ms, %.0f updates/s per core",
+					(unsigned long long) updateCount, updateSeconds * 1000, updateSeconds > 0 ? updateCount / updateSeconds : 0.0);
+
+				ImGui::TreePop();
+			}
+
+			if (renderWorld) {
+				static bool frustumCulling = true;
+				static bool caveCulling = true;
+				ImGui::Checkbox("Frustum culling", &frustumCulling);
+				ImGui::SameLine();
+				ImGui::Checkbox("Cave culling", &caveCulling);
+
+				WorldDrawStats drawStats = drawWorld(frustumCulling, caveCulling);
+				ImGui::Text("sections: %zu visible, %zu culled in %.1f us", drawStats.visibleCount, sectionMeshes.size() - drawStats.visibleCount, drawStats.cullTime.count());
+				ImGui::Text("cave culling: %zu of %zu sections reachable", drawStats.reachableCount, visibilityGraph.getSectionCount());
+
+				ImGui::Text("renderer: %zu draws in 1 call, %zu triangles", chunkRenderer.getDrawCount(), drawStats.triangleCount);
+				{
+					Minecraft::Render::StreamStats stats = streamBuffer.getStats();
+					ImGui::Text("streaming: %llu KiB last frame, waited %.3f ms, %zu frames in flight",
+						(unsigned long long) stats.bytesLastFrame / 1024, std::chrono::duration<double, std::milli>(stats.waitTimeLastFrame).count(), stats.framesInFlight);
+					ImGui::Text("  %llu MiB total, %llu waits for %.1f ms, %llu allocations didn't fit", (unsigned long long) stats.bytesTotal / (1024 * 1024),
+						(unsigned long long) stats.waitCount, std::chrono::duration<double, std::milli>(stats.waitTimeTotal).count(), (unsigned long long) stats.failedCount);
+				}
+				if (ImGui::TreeNode("buffer arenas")) {
+					for (auto [name, stats] : { std::pair("vertices", chunkRenderer.getVertexStats()), std::pair("indices", chunkRenderer.getIndexStats()) }) {
+						ImGui::ProgressBar(stats.occupancy, { ImGui::GetContentRegionAvail().x / 2, 0 });
+						ImGui::SameLine();
+						ImGui::Text("%s: %zu / %zu KiB in %zu ranges", name, stats.used / 1024, stats.capacity / 1024, stats.allocationCount);
+						ImGui::Text("  %zu free ranges, largest %zu KiB, %.0f%% fragmented", stats.freeRangeCount, stats.largestFreeRange / 1024, stats.fragmentation * 100);
+						ImGui::Text("  grown %llu times, defragmented %llu times, %llu KiB moved",
+							(unsigned long long) stats.growCount, (unsigned long long) stats.defragmentCount, (unsigned long long) stats.bytesMoved / 1024);
+					}
+					ImGui::TreePop();
+				}
+
+				program->use();
+			}
+		}
+		{
+			// what the simulation eases the camera towards, the sliders don't move it directly
+			static Minecraft::Game::Input input = simulation.getInput();
+			bool changedInput = false;
+
+			changedInput |= ImGui::SliderFloat("distance", &input.distance, 1, 500, nullptr, ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp);
+			ImGui::BeginGroup();
+			changedInput |= ImGui::SliderAngle("pitch", &input.pitch, -90, 90);
+			changedInput |= ImGui::SliderAngle("Yaw", &input.yaw);
+			changedInput |= ImGui::SliderAngle("Roll", &input.roll);
+			ImGui::EndGroup();
+			ImGui::SameLine();
+			ImGui::BeginGroup();
+			ImGui::BeginDisabled(glm::abs(input.pitch) < 0.01);
+			if (ImGui::Button("reset##pitch", { -FLT_MIN, 0 })) {
+				input.pitch = 0;
+				changedInput = true;
+			}
+			ImGui::EndDisabled();
+			ImGui::BeginDisabled(glm::abs(input.yaw) < 0.01);
+			if (ImGui::Button("reset##yaw", { -FLT_MIN, 0 })) {
+				input.yaw = 0;
+				changedInput = true;
+			}
+			ImGui::EndDisabled();
+			ImGui::BeginDisabled(glm::abs(input.roll) < 0.01);
+			if (ImGui::Button("reset##roll", { -FLT_MIN, 0 })) {
+				input.roll = 0;
+				changedInput = true;
+			}
+			ImGui::EndDisabled();
+			ImGui::EndGroup();
+			ImGui::BeginDisabled(glm::abs(input.pitch) < 0.01 && glm::abs(input.yaw) < 0.01 && glm::abs(input.roll) < 0.01);
+			if (ImGui::Button("reset", { -FLT_MIN, 0 })) {
+				input.pitch = 0;
+				input.yaw = 0;
+				input.roll = 0;
+				changedInput = true;
+			}
+			ImGui::EndDisabled();
+			changedInput |= ImGui::SliderAngle("orbit speed", &input.orbitSpeed, -90, 90, "%.0f deg/s");
+
+			if (changedInput)
+				simulation.setInput(input);
+		}
+		if (ImGui::TreeNode("simulation")) {
+			static int tickRate = (int) simulation.getTickRate();
+			if (ImGui::SliderInt("tick rate", &tickRate, 1, 240, "%d Hz", ImGuiSliderFlags_AlwaysClamp))
+				simulation.setTickRate(tickRate);
+
+			Minecraft::Game::SimulationStats stats = simulation.getStats();
+			ImGui::Text("tick %llu, %.1f s simulated", (unsigned long long) gameState.tick, gameState.time);
+			ImGui::Text("last tick took %.3f ms, %llu ticks skipped", std::chrono::duration<double, std::milli>(stats.lastTickTime).count(), (unsigned long long) stats.skippedTicks);
+
+			ImGui::TreePop();
+		}
+		ImGui::Separator();
+		if (ImGui::TreeNode("jobs")) {
+			ImGui::Text("pending: %zu, main thread: %zu", jobs.getPendingCount(), jobs.getMainThreadPendingCount());
+
+			std::vector<Minecraft::Jobs::WorkerStats> stats = jobs.getStats();
+			for (size_t i = 0; i < stats.size(); i++) {
+				ImGui::ProgressBar(stats[i].utilisation, { ImGui::GetContentRegionAvail().x / 2, 0 });
+				ImGui::SameLine();
+				ImGui::Text("worker %zu: %llu jobs, %llu stolen, %llu cancelled", i,
+					(unsigned long long) stats[i].jobsExecuted, (unsigned long long) stats[i].jobsStolen, (unsigned long long) stats[i].jobsCancelled);
+			}
+
+			if (ImGui::Button("reset"))
+				jobs.resetStats();
+
+			ImGui::TreePop();
+		}
+		if (ImGui::TreeNode("render state")) {
+			Minecraft::Render::RenderStateStats stats = renderState.getStats();
+			uint64_t total = stats.issued + stats.elided;
+			ImGui::Text("state changes: %llu issued, %llu elided (%.0f%%)",
+				(unsigned long long) stats.issued, (unsigned long long) stats.elided, total > 0 ? stats.elided * 100.0 / total : 0.0);
+
+			if (ImGui::Button("reset##render state"))
+				renderState.resetStats();
+
+			ImGui::TreePop();
 		}
 		ImGui::End();
 
 		renderOpenGLConfigMenu();
+		renderProfilerWindow();
 
 		if (ImGui::Begin("textures")) {
 			static glm::ivec2 uv{0, 0};
@@ -673,22 +1348,57 @@ int main() {
 				io.ConfigWindowsMoveFromTitleBarOnly = false;
 			ImGui::SliderInt2("uvs", glm::value_ptr(uv), 0, 15, nullptr, ImGuiSliderFlags_AlwaysClamp);
 			ImGui::Image(img->getId(), {128, 128}, {uv.x / 16.0f, uv.y / 16.0f}, {(uv.x + 1) / 16.0f, (uv.y + 1) / 16.0f});
+
+			ImGui::Separator();
+			{
+				Minecraft::Assets::TextureLoaderStats loaderStats = textureLoader.getStats();
+				Minecraft::Assets::ImageCacheStats cacheStats = imageCache.getStats();
+				ImGui::Text("loader: %zu pending, %llu loaded, %llu failed, %llu KiB uploaded",
+					loaderStats.pending, (unsigned long long) loaderStats.loaded, (unsigned long long) loaderStats.failed, (unsigned long long) loaderStats.bytesUploaded / 1024);
+				ImGui::Text("  decoded in %.1f ms over all workers, %llu images from cache, %llu decoded",
+					std::chrono::duration<double, std::milli>(loaderStats.decodeTime).count(), (unsigned long long) cacheStats.hits, (unsigned long long) cacheStats.misses);
+			}
+			if (blockTextures->isLoaded()) {
+				ImGui::Text("block texture array: %zu layers of %dx%d, %d mip levels",
+					blockTextures->getLayerCount(), blockTextures->getSize().x, blockTextures->getSize().y, blockTextures->getLevelCount());
+				if (ImGui::TreeNode("layers")) {
+					const std::vector<std::string>& names = blockTextures->getLayerNames();
+					for (size_t i = 0; i < names.size(); i++)
+						ImGui::Text("%zu: %s", i, names[i].c_str());
+					ImGui::TreePop();
+				}
+			} else
+				ImGui::Text("block texture array is loading");
 		}
 		ImGui::End();
 
 		ImGui::ShowDemoWindow();
 
-		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		{
+			Minecraft::Profiling::CpuZone zone("imgui render");
+			Minecraft::Profiling::GpuZone gpuZone("imgui render");
+
+			ImGui::Render();
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
-			GLFWwindow* backup_current_context = glfwGetCurrentContext();
-			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault();
-			glfwMakeContextCurrent(backup_current_context);
+			if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+				GLFWwindow* backup_current_context = glfwGetCurrentContext();
+				ImGui::UpdatePlatformWindows();
+				ImGui::RenderPlatformWindowsDefault();
+				glfwMakeContextCurrent(backup_current_context);
+			}
 		}
 
+		recordCounters((time - pTime) * 1000);
 		pTime = time;
-		glfwSwapBuffers(window);
+		streamBuffer.endFrame();
+		{
+			Minecraft::Profiling::CpuZone zone("swap");
+			glfwSwapBuffers(window);
+		}
+
+		profiler.endFrame();
 	}
+
+	Minecraft::Profiling::TraceRecorder::get().stop();
 }
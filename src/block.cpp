@@ -0,0 +1,88 @@
+#include "block.h"
+
+#include <iostream>
+
+namespace Minecraft::World {
+	BlockId BlockRegistry::add(const Block& block) {
+		BlockId id = find(block.name);
+		if (id != AIR || block.name == "air") {
+			std::cerr << "block '" << block.name << "' is already registered" << std::endl;
+			return id;
+		}
+
+		blocks().push_back(block);
+		opaque().push_back(block.isOpaque);
+		light().push_back(block.light);
+
+		return blocks().size() - 1;
+	}
+
+	BlockId BlockRegistry::find(const std::string& name) {
+		std::vector<Block>& list = blocks();
+		for (size_t i = 0; i < list.size(); i++)
+			if (list[i].name == name)
+				return i;
+
+		return AIR;
+	}
+
+	const Block& BlockRegistry::get(BlockId id) {
+		std::vector<Block>& list = blocks();
+		if (id >= list.size())
+			return list[AIR];
+
+		return list[id];
+	}
+
+	bool BlockRegistry::isOpaque(BlockId id) {
+		std::vector<bool>& list = opaque();
+		return id < list.size() && list[id];
+	}
+
+	uint8_t BlockRegistry::getLight(BlockId id) {
+		std::vector<uint8_t>& list = light();
+		return id < list.size() ? list[id] : 0;
+	}
+
+	size_t BlockRegistry::size() {
+		return blocks().size();
+	}
+
+	void BlockRegistry::registerDefaults() {
+		if (blocks().size() > 1)
+			return;
+
+		auto all = [](uint16_t texture) {
+			return std::array<uint16_t, FACE_COUNT>{ texture, texture, texture, texture, texture, texture };
+		};
+
+		// texture indices are layers of the block texture array, which starts with the tiles of 'blocks.png',
+		// counted left to right, top to bottom
+		add({ "stone", true, all(1) });
+		add({ "dirt", true, all(2) });
+		add({ "grass", true, { 3, 3, 2, 0, 3, 3 } });
+		add({ "cobblestone", true, all(16) });
+		add({ "planks", true, all(4) });
+		add({ "sand", true, all(18) });
+		add({ "glass", false, all(49) });
+		add({ "glowstone", true, all(105), 15 });
+	}
+
+	std::vector<Block>& BlockRegistry::blocks() {
+		// air always has id 0
+		static std::vector<Block> blocks = { Block{ "air", false, {} } };
+		return blocks;
+	}
+
+	std::vector<bool>& BlockRegistry::opaque() {
+		// kept separately from 'blocks' so the mesher's hot loop doesn't touch the names
+		static std::vector<bool> opaque = { false };
+		return opaque;
+	}
+
+	std::vector<uint8_t>& BlockRegistry::light() {
+		// kept separately for the same reason as 'opaque'
+		static std::vector<uint8_t> light = { 0 };
+		return light;
+	}
+}
@@ -0,0 +1,218 @@
+#include "bufferArena.h"
+#include "renderState.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+namespace Minecraft::Render {
+	namespace {
+		GLuint createBuffer(size_t size) {
+			GLuint buffer = 0;
+			glCreateBuffers(1, &buffer);
+			glNamedBufferStorage(buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+			return buffer;
+		}
+
+		size_t alignUp(size_t value, size_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	BufferArena::BufferArena(size_t capacity, size_t alignment) : capacity(alignUp(capacity, alignment)), alignment(alignment) {
+		buffer = createBuffer(this->capacity);
+		if (this->capacity > 0)
+			freeRanges[0] = this->capacity;
+	}
+
+	BufferArena::~BufferArena() {
+		if (buffer != 0)
+			RenderState::get().deleteBuffers(1, &buffer);
+	}
+
+	BufferArena::Handle BufferArena::allocate(size_t size) {
+		size = alignUp(std::max<size_t>(size, 1), alignment);
+
+		size_t offset = 0;
+		while (!allocateRange(size, offset))
+			grow(std::max(capacity * 2, capacity + size));
+
+		Handle handle = 0;
+		if (freeHandles.empty()) {
+			handle = allocations.size();
+			allocations.emplace_back();
+		} else {
+			handle = freeHandles.back();
+			freeHandles.pop_back();
+		}
+
+		allocations[handle] = { offset, size, true };
+		return handle;
+	}
+
+	void BufferArena::free(Handle handle) {
+		if (handle == INVALID_HANDLE || handle >= allocations.size() || !allocations[handle].isUsed) {
+			std::cerr << "attempted to free buffer range " << handle << " which isn't allocated" << std::endl;
+			return;
+		}
+
+		Allocation& allocation = allocations[handle];
+		freeRange(allocation.offset, allocation.size);
+		allocation = {};
+		freeHandles.push_back(handle);
+	}
+
+	void BufferArena::write(Handle handle, const void* data, size_t size) {
+		const Allocation& allocation = allocations[handle];
+		if (size > allocation.size) {
+			std::cerr << "attempted to write " << size << " bytes to a buffer range of " << allocation.size << " bytes" << std::endl;
+			return;
+		}
+
+		glNamedBufferSubData(buffer, allocation.offset, size, data);
+	}
+
+	void BufferArena::copy(Handle handle, GLuint source, size_t sourceOffset, size_t size) {
+		const Allocation& allocation = allocations[handle];
+		if (size > allocation.size) {
+			std::cerr << "attempted to copy " << size << " bytes to a buffer range of " << allocation.size << " bytes" << std::endl;
+			return;
+		}
+
+		glCopyNamedBufferSubData(source, buffer, sourceOffset, allocation.offset, size);
+	}
+
+	size_t BufferArena::getOffset(Handle handle) const {
+		return allocations[handle].offset;
+	}
+
+	size_t BufferArena::getSize(Handle handle) const {
+		return allocations[handle].size;
+	}
+
+	GLuint BufferArena::getBuffer() const {
+		return buffer;
+	}
+
+	size_t BufferArena::defragment() {
+		std::vector<Handle> handles;
+		for (Handle handle = 1; handle < allocations.size(); handle++)
+			if (allocations[handle].isUsed)
+				handles.push_back(handle);
+
+		// kept in the same order, so ranges that are already packed don't move
+		std::sort(handles.begin(), handles.end(), [this](Handle a, Handle b) { return allocations[a].offset < allocations[b].offset; });
+
+		// copying within one buffer isn't allowed when the ranges overlap, so everything moves to a new one
+		GLuint newBuffer = createBuffer(capacity);
+		size_t offset = 0;
+		size_t moved = 0;
+		for (Handle handle : handles) {
+			Allocation& allocation = allocations[handle];
+			glCopyNamedBufferSubData(buffer, newBuffer, allocation.offset, offset, allocation.size);
+			allocation.offset = offset;
+			offset += allocation.size;
+			moved += allocation.size;
+		}
+
+		RenderState::get().deleteBuffers(1, &buffer);
+		buffer = newBuffer;
+
+		freeRanges.clear();
+		if (offset < capacity)
+			freeRanges[offset] = capacity - offset;
+
+		defragmentCount++;
+		bytesMoved += moved;
+		return moved;
+	}
+
+	bool BufferArena::defragmentIfNeeded(float threshold) {
+		// a few small gaps aren't worth copying the whole arena for
+		if (freeRanges.size() < 16 || getFragmentation() <= threshold)
+			return false;
+
+		defragment();
+		return true;
+	}
+
+	ArenaStats BufferArena::getStats() const {
+		ArenaStats stats{};
+		stats.capacity = capacity;
+		stats.used = used;
+		stats.allocationCount = allocations.size() - 1 - freeHandles.size();
+		stats.freeRangeCount = freeRanges.size();
+		for (const auto& [offset, size] : freeRanges)
+			stats.largestFreeRange = std::max(stats.largestFreeRange, size);
+		stats.fragmentation = getFragmentation();
+		stats.occupancy = capacity == 0 ? 0 : float(used) / capacity;
+		stats.growCount = growCount;
+		stats.defragmentCount = defragmentCount;
+		stats.bytesMoved = bytesMoved;
+		return stats;
+	}
+
+	bool BufferArena::allocateRange(size_t size, size_t& offset) {
+		for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+			auto [rangeOffset, rangeSize] = *it;
+			if (rangeSize < size)
+				continue;
+
+			freeRanges.erase(it);
+			if (rangeSize > size)
+				freeRanges[rangeOffset + size] = rangeSize - size;
+
+			offset = rangeOffset;
+			used += size;
+			return true;
+		}
+
+		return false;
+	}
+
+	void BufferArena::freeRange(size_t offset, size_t size) {
+		used -= size;
+		auto it = freeRanges.emplace(offset, size).first;
+
+		if (auto next = std::next(it); next != freeRanges.end() && it->first + it->second == next->first) {
+			it->second += next->second;
+			freeRanges.erase(next);
+		}
+
+		if (it != freeRanges.begin()) {
+			if (auto previous = std::prev(it); previous->first + previous->second == it->first) {
+				previous->second += it->second;
+				freeRanges.erase(it);
+			}
+		}
+	}
+
+	void BufferArena::grow(size_t newCapacity) {
+		newCapacity = alignUp(newCapacity, alignment);
+
+		GLuint newBuffer = createBuffer(newCapacity);
+		if (capacity > 0)
+			glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, capacity);
+		RenderState::get().deleteBuffers(1, &buffer);
+		buffer = newBuffer;
+
+		// 'freeRange' expects the range to have been in use
+		used += newCapacity - capacity;
+		freeRange(capacity, newCapacity - capacity);
+		capacity = newCapacity;
+
+		growCount++;
+	}
+
+	float BufferArena::getFragmentation() const {
+		size_t freeBytes = capacity - used;
+		if (freeBytes == 0)
+			return 0;
+
+		size_t largest = 0;
+		for (const auto& [offset, size] : freeRanges)
+			largest = std::max(largest, size);
+
+		return 1 - float(largest) / freeBytes;
+	}
+}
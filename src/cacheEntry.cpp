@@ -0,0 +1,111 @@
+#include "cacheEntry.h"
+#include "binary.h"
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace Minecraft::IO {
+	namespace {
+		/// magic, version, metadata length, key length, payload length
+		constexpr size_t HEADER_SIZE = 4 + 1 + 4 + 4 + 8;
+
+		/// makes the names of files being written unique, so two threads storing the same entry don't write the same file
+		std::atomic<uint64_t> writeCount = 0;
+	}
+
+	std::filesystem::path CacheEntry::getPath(const std::filesystem::path& directory, std::string_view key, std::string_view extension) {
+		uint32_t hash = checksum({ (const uint8_t*) key.data(), key.size() });
+		return directory / std::format("{:08x}.{}", hash, extension);
+	}
+
+	std::shared_ptr<CacheEntry> CacheEntry::read(const std::filesystem::path& path, std::string_view magic, uint8_t version, std::string_view key) {
+		if (!std::filesystem::exists(path))
+			return nullptr;
+
+		std::shared_ptr<MappedFile> file = MappedFile::open(path);
+		if (!file)
+			return nullptr;
+
+		std::span<const uint8_t> data = file->getData();
+		if (data.size() < HEADER_SIZE || std::memcmp(data.data(), magic.data(), 4) != 0 || data[4] != version)
+			return nullptr;
+
+		uint32_t metadataLength = readLittleEndian<uint32_t>(data, 5);
+		uint32_t keyLength = readLittleEndian<uint32_t>(data, 9);
+		uint64_t payloadLength = readLittleEndian<uint64_t>(data, 13);
+		size_t offset = HEADER_SIZE;
+		if (data.size() - offset < uint64_t(metadataLength) + keyLength + 4 || data.size() - offset - metadataLength - keyLength - 4 != payloadLength)
+			return nullptr;
+
+		std::span<const uint8_t> metadata = data.subspan(offset, metadataLength);
+		offset += metadataLength;
+
+		// a different key with the same hash
+		if (std::string_view((const char*) data.data() + offset, keyLength) != key)
+			return nullptr;
+		offset += keyLength;
+
+		uint32_t expected = readLittleEndian<uint32_t>(data, offset);
+		std::span<const uint8_t> payload = data.subspan(offset + 4, payloadLength);
+		if (checksum(payload) != expected)
+			return nullptr;
+
+		std::shared_ptr<CacheEntry> entry(new CacheEntry());
+		entry->file = std::move(file);
+		entry->metadata = metadata;
+		entry->payload = payload;
+		return entry;
+	}
+
+	bool CacheEntry::write(const std::filesystem::path& path, std::string_view magic, uint8_t version, std::string_view key,
+		std::span<const uint8_t> metadata, std::span<const uint8_t> payload) {
+		std::vector<uint8_t> header;
+		header.reserve(HEADER_SIZE + metadata.size() + key.size() + 4);
+		header.insert(header.end(), magic.begin(), magic.begin() + 4);
+		header.push_back(version);
+		writeLittleEndian<uint32_t>(header, metadata.size());
+		writeLittleEndian<uint32_t>(header, key.size());
+		writeLittleEndian<uint64_t>(header, payload.size());
+		header.insert(header.end(), metadata.begin(), metadata.end());
+		header.insert(header.end(), key.begin(), key.end());
+		writeLittleEndian(header, checksum(payload));
+
+		std::error_code error;
+		std::filesystem::create_directories(path.parent_path(), error);
+
+		std::filesystem::path temporary = path;
+		temporary += std::format(".{}.tmp", writeCount++);
+		{
+			std::ofstream out(temporary, std::ios::binary);
+			out.write((const char*) header.data(), header.size());
+			out.write((const char*) payload.data(), payload.size());
+			if (!out) {
+				std::cerr << "couldn't write cache entry '" << temporary << "'" << std::endl;
+				out.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporary, path, error);
+		if (error) {
+			std::cerr << "couldn't write cache entry '" << path << "': " << error.message() << std::endl;
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	std::span<const uint8_t> CacheEntry::getMetadata() const {
+		return metadata;
+	}
+
+	std::span<const uint8_t> CacheEntry::getPayload() const {
+		return payload;
+	}
+}
@@ -0,0 +1,43 @@
+#include "cameraBuffer.h"
+#include "glDebug.h"
+#include "renderState.h"
+
+#include <cstring>
+
+namespace Minecraft::Assets {
+	CameraBuffer::CameraBuffer() {
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, sizeof(CameraUniforms), &uniforms, GL_DYNAMIC_STORAGE_BIT);
+		Render::setLabel(GL_BUFFER, buffer, "camera");
+
+		bind();
+	}
+
+	CameraBuffer::~CameraBuffer() {
+		if (buffer != 0)
+			Render::RenderState::get().deleteBuffers(1, &buffer);
+	}
+
+	void CameraBuffer::update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position) {
+		CameraUniforms updated = {
+			.viewMatrix = view,
+			.projectionMatrix = projection,
+			.viewProjectionMatrix = projection * view,
+			.cameraPosition = glm::vec4(position, 1),
+		};
+
+		if (std::memcmp(&updated, &uniforms, sizeof(CameraUniforms)) == 0)
+			return;
+
+		uniforms = updated;
+		glNamedBufferSubData(buffer, 0, sizeof(CameraUniforms), &uniforms);
+	}
+
+	void CameraBuffer::bind() const {
+		Render::RenderState::get().bindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BINDING, buffer);
+	}
+
+	const CameraUniforms& CameraBuffer::getUniforms() const {
+		return uniforms;
+	}
+}
@@ -0,0 +1,83 @@
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "cameraPath.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace Minecraft::Assets {
+	std::shared_ptr<CameraPath> CameraPath::load(const std::filesystem::path& path) {
+		std::ifstream in(path);
+		if (!in) {
+			std::cerr << "could not open camera path '" << path << "'" << std::endl;
+			return nullptr;
+		}
+
+		std::shared_ptr<CameraPath> cameraPath(new CameraPath());
+
+		std::string line;
+		for (size_t lineNumber = 1; std::getline(in, line); lineNumber++) {
+			size_t start = line.find_first_not_of(" \t\r");
+			if (start == std::string::npos || line[start] == '#')
+				continue;
+
+			Keyframe keyframe;
+			glm::vec2 degrees;
+			std::istringstream values(line);
+			if (!(values >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >> degrees.x >> degrees.y)) {
+				std::cerr << "camera path '" << path << "' has an invalid keyframe on line " << lineNumber << std::endl;
+				return nullptr;
+			}
+			keyframe.rotation = glm::radians(degrees);
+
+			cameraPath->keyframes.push_back(keyframe);
+		}
+
+		if (cameraPath->keyframes.empty()) {
+			std::cerr << "camera path '" << path << "' has no keyframes" << std::endl;
+			return nullptr;
+		}
+
+		std::ranges::stable_sort(cameraPath->keyframes, {}, &Keyframe::time);
+		return cameraPath;
+	}
+
+	CameraPath::Keyframe CameraPath::sample(float time) const {
+		if (time <= keyframes.front().time)
+			return keyframes.front();
+		if (time >= keyframes.back().time)
+			return keyframes.back();
+
+		auto next = std::ranges::upper_bound(keyframes, time, {}, &Keyframe::time);
+		auto previous = next - 1;
+
+		float duration = next->time - previous->time;
+		float t = duration > 0 ? (time - previous->time) / duration : 1;
+
+		return {
+			time,
+			glm::mix(previous->position, next->position, t),
+			glm::mix(previous->rotation, next->rotation, t),
+		};
+	}
+
+	glm::mat4 CameraPath::getView(float time) const {
+		Keyframe keyframe = sample(time);
+
+		glm::mat4 rotation = glm::yawPitchRoll(keyframe.rotation.x, keyframe.rotation.y, 0.0f);
+		glm::vec3 forward(rotation * glm::vec4(0, 0, -1, 0));
+		glm::vec3 up(rotation * glm::vec4(0, 1, 0, 0));
+
+		return glm::lookAt(keyframe.position, keyframe.position + forward, up);
+	}
+
+	float CameraPath::getDuration() const {
+		return keyframes.back().time;
+	}
+}
@@ -0,0 +1,266 @@
+#include "chunk.h"
+#include "binary.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Minecraft::World {
+	namespace {
+		constexpr uint8_t FORMAT_VERSION = 1;
+	}
+
+	Chunk::Chunk(glm::ivec2 position) : position(position) {}
+
+	BlockId Chunk::getBlock(int x, int y, int z) const {
+		if (y < 0 || y >= HEIGHT)
+			return AIR;
+
+		const ChunkSection* section = getSection(y / ChunkSection::SIZE);
+		if (!section)
+			return AIR;
+
+		return section->getBlock(x, y % ChunkSection::SIZE, z);
+	}
+
+	BlockId Chunk::setBlock(int x, int y, int z, BlockId block) {
+		if (y < 0 || y >= HEIGHT)
+			return AIR;
+
+		int sectionY = y / ChunkSection::SIZE;
+		if (block == AIR && !sections[sectionY])
+			return AIR;
+
+		BlockId oldBlock = getOrCreateSection(sectionY).setBlock(x, y % ChunkSection::SIZE, z, block);
+		modified |= oldBlock != block;
+
+		return oldBlock;
+	}
+
+	ChunkSection* Chunk::getSection(int sectionY) {
+		if (sectionY < 0 || sectionY >= SECTION_COUNT)
+			return nullptr;
+
+		return sections[sectionY].get();
+	}
+
+	const ChunkSection* Chunk::getSection(int sectionY) const {
+		if (sectionY < 0 || sectionY >= SECTION_COUNT)
+			return nullptr;
+
+		return sections[sectionY].get();
+	}
+
+	ChunkSection& Chunk::getOrCreateSection(int sectionY) {
+		std::unique_ptr<ChunkSection>& section = sections[sectionY];
+		if (!section)
+			section = std::make_unique<ChunkSection>();
+
+		return *section;
+	}
+
+	void Chunk::trim() {
+		for (std::unique_ptr<ChunkSection>& section : sections)
+			if (section && section->isEmpty())
+				section.reset();
+	}
+
+	const SectionLight* Chunk::getLight(int sectionY) const {
+		if (sectionY < 0 || sectionY >= SECTION_COUNT)
+			return nullptr;
+
+		if (dark[sectionY])
+			return &SectionLight::dark();
+
+		return light[sectionY].get();
+	}
+
+	uint8_t Chunk::getLight(LightType type, int x, int y, int z) const {
+		if (y < 0 || y >= HEIGHT)
+			return SectionLight::defaultLevel(type);
+
+		const SectionLight* sectionLight = light[y / ChunkSection::SIZE].get();
+		if (!sectionLight)
+			return dark[y / ChunkSection::SIZE] ? 0 : SectionLight::defaultLevel(type);
+
+		return sectionLight->get(type, ChunkSection::index(x, y % ChunkSection::SIZE, z));
+	}
+
+	void Chunk::setLight(LightType type, int x, int y, int z, uint8_t level) {
+		if (y < 0 || y >= HEIGHT)
+			return;
+
+		int sectionY = y / ChunkSection::SIZE;
+		std::unique_ptr<SectionLight>& sectionLight = light[sectionY];
+		if (!sectionLight) {
+			if (level == (dark[sectionY] ? 0 : SectionLight::defaultLevel(type)))
+				return;
+			sectionLight = std::make_unique<SectionLight>(dark[sectionY] ? 0 : SectionLight::defaultLevel(LightType::SKY));
+			dark[sectionY] = false;
+		}
+
+		sectionLight->set(type, ChunkSection::index(x, y % ChunkSection::SIZE, z), level);
+	}
+
+	void Chunk::darken(int sectionY) {
+		if (sectionY < 0 || sectionY >= SECTION_COUNT)
+			return;
+
+		light[sectionY].reset();
+		dark[sectionY] = true;
+	}
+
+	void Chunk::trimLight() {
+		for (int sectionY = 0; sectionY < SECTION_COUNT; sectionY++) {
+			std::unique_ptr<SectionLight>& sectionLight = light[sectionY];
+			if (!sectionLight)
+				continue;
+
+			if (sectionLight->isUniform(SectionLight::defaultLevel(LightType::SKY))) {
+				sectionLight.reset();
+			} else if (sectionLight->isUniform(0)) {
+				sectionLight.reset();
+				dark[sectionY] = true;
+			}
+		}
+	}
+
+	glm::ivec2 Chunk::getPosition() const {
+		return position;
+	}
+
+	size_t Chunk::getMemoryUsage() const {
+		size_t usage = sizeof(Chunk);
+		for (const std::unique_ptr<ChunkSection>& section : sections)
+			if (section)
+				usage += section->getMemoryUsage();
+		for (const std::unique_ptr<SectionLight>& sectionLight : light)
+			if (sectionLight)
+				usage += sizeof(SectionLight);
+
+		return usage;
+	}
+
+	bool Chunk::isModified() const {
+		return modified;
+	}
+
+	void Chunk::setModified(bool modified) {
+		this->modified = modified;
+	}
+
+	// version, then a mask of the sections that are stored, followed by those sections from the bottom up
+	// each section is its palette, and unless it's uniform an index into the palette for every block
+	// indices are a byte when the palette allows it, the compression takes care of the remaining redundancy
+	std::vector<uint8_t> Chunk::serialize() const {
+		std::vector<uint8_t> out;
+
+		uint16_t mask = 0;
+		for (int y = 0; y < SECTION_COUNT; y++)
+			if (sections[y] && !sections[y]->isEmpty())
+				mask |= 1 << y;
+
+		IO::writeLittleEndian(out, FORMAT_VERSION);
+		IO::writeLittleEndian(out, mask);
+
+		std::vector<BlockId> palette;
+		std::vector<uint16_t> indices(ChunkSection::VOLUME);
+		for (int y = 0; y < SECTION_COUNT; y++) {
+			if (!(mask & 1 << y))
+				continue;
+
+			// the section palette can have free entries, so a compact one is built instead
+			const ChunkSection& section = *sections[y];
+			palette.clear();
+			BlockId lastBlock = section.getBlock(0);
+			uint16_t lastIndex = 0;
+			palette.push_back(lastBlock);
+			for (int i = 0; i < ChunkSection::VOLUME; i++) {
+				BlockId block = section.getBlock(i);
+				if (block != lastBlock) {
+					lastBlock = block;
+					auto it = std::find(palette.begin(), palette.end(), block);
+					lastIndex = it - palette.begin();
+					if (it == palette.end())
+						palette.push_back(block);
+				}
+				indices[i] = lastIndex;
+			}
+
+			IO::writeLittleEndian(out, uint16_t(palette.size()));
+			for (BlockId block : palette)
+				IO::writeLittleEndian(out, block);
+
+			if (palette.size() == 1)
+				continue;
+
+			if (palette.size() <= 256)
+				for (uint16_t index : indices)
+					out.push_back(uint8_t(index));
+			else
+				for (uint16_t index : indices)
+					IO::writeLittleEndian(out, index);
+		}
+
+		return out;
+	}
+
+	std::shared_ptr<Chunk> Chunk::deserialize(glm::ivec2 position, std::span<const uint8_t> data) {
+		auto corrupted = [position]() {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] is corrupted" << std::endl;
+			return nullptr;
+		};
+
+		size_t offset = 0;
+		auto has = [&data, &offset](size_t bytes) { return data.size() - offset >= bytes; };
+
+		if (!has(3) || data[0] != FORMAT_VERSION)
+			return corrupted();
+
+		uint16_t mask = IO::readLittleEndian<uint16_t>(data, 1);
+		offset = 3;
+
+		std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(position);
+		std::vector<BlockId> palette;
+		std::vector<BlockId> blocks(ChunkSection::VOLUME);
+		for (int y = 0; y < SECTION_COUNT; y++) {
+			if (!(mask & 1 << y))
+				continue;
+
+			if (!has(2))
+				return corrupted();
+			uint16_t paletteSize = IO::readLittleEndian<uint16_t>(data, offset);
+			offset += 2;
+
+			if (paletteSize == 0 || !has(paletteSize * 2))
+				return corrupted();
+			palette.resize(paletteSize);
+			for (BlockId& block : palette) {
+				block = IO::readLittleEndian<BlockId>(data, offset);
+				offset += 2;
+			}
+
+			if (paletteSize == 1) {
+				chunk->getOrCreateSection(y).fill(palette[0]);
+				continue;
+			}
+
+			size_t indexSize = paletteSize <= 256 ? 1 : 2;
+			if (!has(ChunkSection::VOLUME * indexSize))
+				return corrupted();
+
+			for (int i = 0; i < ChunkSection::VOLUME; i++, offset += indexSize) {
+				uint16_t index = indexSize == 1 ? data[offset] : IO::readLittleEndian<uint16_t>(data, offset);
+				if (index >= paletteSize)
+					return corrupted();
+				blocks[i] = palette[index];
+			}
+
+			chunk->getOrCreateSection(y).setBlocks(std::span<const BlockId, ChunkSection::VOLUME>(blocks));
+		}
+
+		if (offset != data.size())
+			return corrupted();
+
+		return chunk;
+	}
+}
@@ -0,0 +1,383 @@
+#include "chunkLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace Minecraft::World {
+	ChunkLoader::ChunkLoader(World& world, Jobs::JobSystem& jobs, int viewDistance) : world(world), jobs(jobs), viewDistance(viewDistance) {}
+
+	ChunkLoader::~ChunkLoader() {
+		*isAlive = false;
+
+		for (auto& [position, entry] : entries)
+			entry.job.cancel();
+
+		jobs.waitIdle();
+
+		for (auto& [position, entry] : entries)
+			if (std::shared_ptr<Chunk> chunk = world.getChunk(position); chunk && chunk->isModified())
+				save(std::move(chunk));
+
+		jobs.waitIdle();
+	}
+
+	void ChunkLoader::onMeshed(MeshCallback callback) {
+		meshCallback = std::move(callback);
+	}
+
+	void ChunkLoader::onUnloaded(UnloadCallback callback) {
+		unloadCallback = std::move(callback);
+	}
+
+	void ChunkLoader::update(glm::ivec2 center) {
+		this->center = center;
+
+		// chunks one further than the view distance are generated, but not meshed, as meshing needs all neighbours
+		int loadDistance = viewDistance + 1;
+
+		for (auto it = entries.begin(); it != entries.end();) {
+			auto& [position, entry] = *it;
+			// locked chunks are unloaded once their lighting job is done, so nothing else writes them in the meantime
+			if (isInRange(position, loadDistance) || locked.contains(position)) {
+				it++;
+				continue;
+			}
+
+			if (entry.job.cancel()) {
+				cancelledCount++;
+				if (entry.state == State::MESHING)
+					releaseReaders(position);
+			}
+			if (entry.hasMesh && unloadCallback)
+				unloadCallback(position);
+
+			if (std::shared_ptr<Chunk> chunk = world.getChunk(position); chunk && chunk->isModified())
+				save(std::move(chunk));
+
+			world.removeChunk(position);
+			it = entries.erase(it);
+		}
+
+		std::vector<glm::ivec2> missing;
+		for (int z = -loadDistance; z <= loadDistance; z++)
+			for (int x = -loadDistance; x <= loadDistance; x++)
+				if (glm::ivec2 position = center + glm::ivec2(x, z); isInRange(position, loadDistance) && !entries.contains(position))
+					missing.push_back(position);
+
+		// closest first, as jobs of the same priority are picked up roughly in order
+		auto distance = [center](glm::ivec2 position) { glm::ivec2 d = position - center; return d.x * d.x + d.y * d.y; };
+		std::sort(missing.begin(), missing.end(), [&distance](glm::ivec2 a, glm::ivec2 b) { return distance(a) < distance(b); });
+
+		for (glm::ivec2 position : missing)
+			generate(position, distance(position) <= 4 ? Jobs::Priority::HIGH : Jobs::Priority::NORMAL);
+
+		for (auto& [position, entry] : entries) {
+			if (entry.state == State::GENERATING || !isInRange(position, viewDistance))
+				continue;
+
+			if ((!entry.isLit || !entry.pendingBlocks.empty()) && canLight(position))
+				light(position, entry);
+		}
+
+		for (auto& [position, entry] : entries) {
+			if (entry.state != State::GENERATED || !entry.isLit || !isInRange(position, viewDistance))
+				continue;
+
+			if (canMesh(position))
+				mesh(position, entry);
+		}
+	}
+
+	bool ChunkLoader::setBlock(glm::ivec3 position, BlockId block) {
+		auto it = entries.find(World::chunkPosition(position));
+		if (it == entries.end() || position.y < 0 || position.y >= Chunk::HEIGHT)
+			return false;
+
+		it->second.pendingBlocks.push_back({ position, block });
+		return true;
+	}
+
+	void ChunkLoader::setViewDistance(int viewDistance) {
+		this->viewDistance = std::max(viewDistance, 0);
+	}
+
+	int ChunkLoader::getViewDistance() const {
+		return viewDistance;
+	}
+
+	size_t ChunkLoader::getGeneratingCount() const {
+		return std::count_if(entries.begin(), entries.end(), [](const auto& entry) { return entry.second.state == State::GENERATING; });
+	}
+
+	size_t ChunkLoader::getMeshingCount() const {
+		return std::count_if(entries.begin(), entries.end(), [](const auto& entry) { return entry.second.state == State::MESHING; });
+	}
+
+	size_t ChunkLoader::getMeshedCount() const {
+		return std::count_if(entries.begin(), entries.end(), [](const auto& entry) { return entry.second.state == State::MESHED; });
+	}
+
+	size_t ChunkLoader::getLightingCount() const {
+		return lightingCount;
+	}
+
+	uint64_t ChunkLoader::getLightUpdateCount() const {
+		return lightUpdateCount;
+	}
+
+	std::chrono::nanoseconds ChunkLoader::getLightUpdateTime() const {
+		return std::chrono::nanoseconds(lightUpdateNanoseconds);
+	}
+
+	uint64_t ChunkLoader::getCancelledCount() const {
+		return cancelledCount;
+	}
+
+	size_t ChunkLoader::getSavingCount() const {
+		return saving.size();
+	}
+
+	uint64_t ChunkLoader::getLoadedCount() const {
+		return loadedCount;
+	}
+
+	uint64_t ChunkLoader::getSavedCount() const {
+		return savedCount;
+	}
+
+	void ChunkLoader::generate(glm::ivec2 position, Jobs::Priority priority) {
+		Entry& entry = entries[position];
+		entry.ticket = nextTicket++;
+
+		// the chunk on disk is outdated until the save finishes
+		if (auto it = saving.find(position); it != saving.end()) {
+			world.setChunk(it->second);
+			entry.state = State::GENERATED;
+			return;
+		}
+
+		entry.state = State::GENERATING;
+
+		uint64_t ticket = entry.ticket;
+		const TerrainGenerator& generator = world.getGenerator();
+		RegionStorage& storage = world.getStorage();
+		entry.job = jobs.submit([this, position, ticket, &generator, &storage, isAlive = isAlive]() {
+			std::shared_ptr<Chunk> chunk = storage.load(position);
+			if (chunk) {
+				loadedCount++;
+			} else {
+				chunk = std::make_shared<Chunk>(position);
+				generator.generate(*chunk);
+				// not on disk yet, so it's saved once it's unloaded
+				chunk->setModified(true);
+			}
+			// light isn't saved, the light of the neighbours is added by a lighting job once they're loaded
+			Lighting::lightChunk(*chunk);
+
+			jobs.submitToMainThread([this, position, ticket, chunk, isAlive]() {
+				if (!*isAlive)
+					return;
+
+				auto it = entries.find(position);
+				if (it == entries.end() || it->second.ticket != ticket)
+					return;
+
+				world.setChunk(chunk);
+				it->second.state = State::GENERATED;
+			});
+		}, priority);
+	}
+
+	bool ChunkLoader::canLight(glm::ivec2 position) const {
+		for (int z = -1; z <= 1; z++) {
+			for (int x = -1; x <= 1; x++) {
+				glm::ivec2 neighbour = position + glm::ivec2(x, z);
+				if (locked.contains(neighbour))
+					return false;
+				if (auto it = readers.find(neighbour); it != readers.end() && it->second > 0)
+					return false;
+			}
+		}
+
+		// the light can only be spread once every neighbour is there to spread it to
+		for (glm::ivec2 offset : { glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1) }) {
+			auto it = entries.find(position + offset);
+			if (it == entries.end() || it->second.state == State::GENERATING)
+				return false;
+		}
+
+		// changing blocks while the chunk is being written to disk would race with the save
+		return entries.at(position).pendingBlocks.empty() || !saving.contains(position);
+	}
+
+	void ChunkLoader::light(glm::ivec2 position, Entry& entry) {
+		std::array<std::shared_ptr<Chunk>, LightRegion::CHUNK_COUNT> chunks = {};
+		std::vector<glm::ivec2> lockedChunks;
+		for (int z = 0; z < LightRegion::WIDTH; z++) {
+			for (int x = 0; x < LightRegion::WIDTH; x++) {
+				glm::ivec2 chunkPosition = position + glm::ivec2(x, z) - 1;
+				if (std::shared_ptr<Chunk> chunk = world.getChunk(chunkPosition)) {
+					chunks[x + z * LightRegion::WIDTH] = std::move(chunk);
+					lockedChunks.push_back(chunkPosition);
+					locked.insert(chunkPosition);
+				}
+			}
+		}
+		lightingCount++;
+
+		bool spreadBorders = !entry.isLit;
+		std::vector<std::pair<glm::ivec3, BlockId>> blocks = std::move(entry.pendingBlocks);
+		entry.pendingBlocks.clear();
+
+		uint64_t ticket = entry.ticket;
+		auto region = std::make_shared<LightRegion>(position, std::move(chunks));
+		entry.job = jobs.submit([this, position, ticket, region, lockedChunks, spreadBorders, blocks, isAlive = isAlive]() {
+			if (spreadBorders)
+				Lighting::spreadBorders(*region);
+
+			if (!blocks.empty()) {
+				auto start = std::chrono::steady_clock::now();
+				uint64_t updates = 0;
+				for (auto [blockPosition, block] : blocks)
+					updates += Lighting::setBlock(*region, blockPosition, block);
+
+				lightUpdateNanoseconds += (std::chrono::steady_clock::now() - start).count();
+				lightUpdateCount += updates;
+			}
+
+			jobs.submitToMainThread([this, position, ticket, region, lockedChunks, spreadBorders, isAlive]() {
+				if (!*isAlive)
+					return;
+
+				for (glm::ivec2 chunkPosition : lockedChunks)
+					locked.erase(chunkPosition);
+				lightingCount--;
+
+				if (auto it = entries.find(position); it != entries.end() && it->second.ticket == ticket)
+					it->second.isLit |= spreadBorders;
+
+				// meshed chunks are meshed again by the next update, the old meshes are shown until then
+				for (glm::ivec2 chunkPosition : region->getChangedChunks())
+					if (auto it = entries.find(chunkPosition); it != entries.end() && it->second.state == State::MESHED)
+						it->second.state = State::GENERATED;
+			});
+		}, Jobs::Priority::HIGH);
+	}
+
+	bool ChunkLoader::canMesh(glm::ivec2 position) const {
+		if (locked.contains(position))
+			return false;
+
+		for (glm::ivec2 offset : { glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1) }) {
+			auto it = entries.find(position + offset);
+			if (it == entries.end() || it->second.state == State::GENERATING || locked.contains(position + offset))
+				return false;
+		}
+
+		return true;
+	}
+
+	void ChunkLoader::mesh(glm::ivec2 position, Entry& entry) {
+		entry.state = State::MESHING;
+
+		// lighting jobs wait for the reads to end, as they would change the light while it's being meshed
+		readers[position]++;
+		for (glm::ivec2 offset : { glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1) })
+			readers[position + offset]++;
+
+		// the job holds on to the chunks, so they stay valid even if they're unloaded before it runs
+		std::shared_ptr<const Chunk> chunk = world.getChunk(position);
+		std::array<std::shared_ptr<const Chunk>, 4> neighbours = {
+			world.getChunk(position + glm::ivec2(-1, 0)),
+			world.getChunk(position + glm::ivec2(1, 0)),
+			world.getChunk(position + glm::ivec2(0, -1)),
+			world.getChunk(position + glm::ivec2(0, 1)),
+		};
+
+		uint64_t ticket = entry.ticket;
+		entry.job = jobs.submit([this, position, ticket, chunk, neighbours, isAlive = isAlive]() {
+			auto meshes = std::make_shared<std::array<ChunkMesh, Chunk::SECTION_COUNT>>();
+
+			for (int y = 0; y < Chunk::SECTION_COUNT; y++) {
+				const ChunkSection* section = chunk->getSection(y);
+				if (!section)
+					continue;
+
+				Mesher::Neighbours sections{};
+				sections[static_cast<int>(Face::NEG_X)] = neighbours[0]->getSection(y);
+				sections[static_cast<int>(Face::POS_X)] = neighbours[1]->getSection(y);
+				sections[static_cast<int>(Face::NEG_Y)] = chunk->getSection(y - 1);
+				sections[static_cast<int>(Face::POS_Y)] = chunk->getSection(y + 1);
+				sections[static_cast<int>(Face::NEG_Z)] = neighbours[2]->getSection(y);
+				sections[static_cast<int>(Face::POS_Z)] = neighbours[3]->getSection(y);
+
+				MeshLight light{};
+				light.section = chunk->getLight(y);
+				light.neighbours[static_cast<int>(Face::NEG_X)] = neighbours[0]->getLight(y);
+				light.neighbours[static_cast<int>(Face::POS_X)] = neighbours[1]->getLight(y);
+				light.neighbours[static_cast<int>(Face::NEG_Y)] = chunk->getLight(y - 1);
+				light.neighbours[static_cast<int>(Face::POS_Y)] = chunk->getLight(y + 1);
+				light.neighbours[static_cast<int>(Face::NEG_Z)] = neighbours[2]->getLight(y);
+				light.neighbours[static_cast<int>(Face::POS_Z)] = neighbours[3]->getLight(y);
+
+				(*meshes)[y] = Mesher::mesh(*section, sections, true, light);
+			}
+
+			jobs.submitToMainThread([this, position, ticket, meshes, isAlive]() {
+				if (!*isAlive)
+					return;
+
+				releaseReaders(position);
+
+				auto it = entries.find(position);
+				if (it == entries.end() || it->second.ticket != ticket)
+					return;
+
+				it->second.state = State::MESHED;
+				it->second.hasMesh = true;
+				if (meshCallback)
+					for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+						meshCallback({ position.x, y, position.y }, std::move((*meshes)[y]));
+			});
+		});
+	}
+
+	void ChunkLoader::releaseReaders(glm::ivec2 position) {
+		for (glm::ivec2 offset : { glm::ivec2(0, 0), glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1) })
+			if (auto it = readers.find(position + offset); it != readers.end() && --it->second == 0)
+				readers.erase(it);
+	}
+
+	void ChunkLoader::save(std::shared_ptr<Chunk> chunk) {
+		glm::ivec2 position = chunk->getPosition();
+		saving[position] = chunk;
+		// cleared before the job is submitted, as blocks aren't changed while the save is in flight
+		// so a chunk that comes back from 'saving' unchanged isn't written again
+		chunk->setModified(false);
+
+		RegionStorage& storage = world.getStorage();
+		jobs.submit([this, chunk, position, &storage, isAlive = isAlive]() {
+			bool saved = storage.save(*chunk);
+			if (saved)
+				savedCount++;
+
+			jobs.submitToMainThread([this, chunk, position, saved, isAlive]() {
+				if (!*isAlive)
+					return;
+
+				// tried again on the next unload
+				if (!saved)
+					chunk->setModified(true);
+
+				if (auto it = saving.find(position); it != saving.end() && it->second == chunk)
+					saving.erase(it);
+			});
+		}, Jobs::Priority::LOW);
+	}
+
+	bool ChunkLoader::isInRange(glm::ivec2 position, int distance) const {
+		glm::ivec2 d = position - center;
+		return d.x * d.x + d.y * d.y <= distance * distance;
+	}
+}
@@ -0,0 +1,174 @@
+#include "chunkRenderer.h"
+#include "glDebug.h"
+#include "renderState.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Minecraft::Render {
+	namespace {
+		GLuint createBuffer(size_t size) {
+			GLuint buffer = 0;
+			glCreateBuffers(1, &buffer);
+			glNamedBufferStorage(buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+			return buffer;
+		}
+	}
+
+	ChunkRenderer::ChunkRenderer(StreamBuffer& stream, size_t vertexCapacity, size_t indexCapacity) :
+		stream(stream), vertices(vertexCapacity, sizeof(World::ChunkVertex)), indices(indexCapacity, sizeof(GLuint)) {
+		GLint alignment = 0;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		storageAlignment = std::max(alignment, 16);
+
+		glCreateVertexArrays(1, &vao);
+		setLabel(GL_VERTEX_ARRAY, vao, "chunk sections");
+		bindBuffers();
+
+		// see 'chunk.vert'
+		glEnableVertexArrayAttrib(vao, 0);
+		glVertexArrayAttribIFormat(vao, 0, 2, GL_UNSIGNED_INT, 0);
+		glVertexArrayAttribBinding(vao, 0, 0);
+	}
+
+	ChunkRenderer::~ChunkRenderer() {
+		GLuint buffers[] = { commandBuffer, originBuffer };
+		RenderState::get().deleteBuffers(2, buffers);
+		RenderState::get().deleteVertexArrays(1, &vao);
+	}
+
+	void ChunkRenderer::upload(glm::ivec3 sectionPosition, const World::ChunkMesh& mesh) {
+		remove(sectionPosition);
+
+		if (mesh.isEmpty())
+			return;
+
+		size_t vertexBytes = mesh.vertices.size() * sizeof(World::ChunkVertex);
+		size_t indexBytes = mesh.indices.size() * sizeof(GLuint);
+
+		Section section{};
+		section.vertices = vertices.allocate(vertexBytes);
+		section.indices = indices.allocate(indexBytes);
+		section.indexCount = mesh.indices.size();
+
+		write(vertices, section.vertices, mesh.vertices.data(), vertexBytes);
+		write(indices, section.indices, mesh.indices.data(), indexBytes);
+
+		sections[sectionPosition] = section;
+	}
+
+	void ChunkRenderer::remove(glm::ivec3 sectionPosition) {
+		auto it = sections.find(sectionPosition);
+		if (it == sections.end())
+			return;
+
+		vertices.free(it->second.vertices);
+		indices.free(it->second.indices);
+		sections.erase(it);
+	}
+
+	bool ChunkRenderer::contains(glm::ivec3 sectionPosition) const {
+		return sections.contains(sectionPosition);
+	}
+
+	void ChunkRenderer::draw(std::span<const glm::ivec3> sectionPositions) {
+		// done before the commands are built, as it moves the ranges
+		vertices.defragmentIfNeeded();
+		indices.defragmentIfNeeded();
+		bindBuffers();
+
+		commands.clear();
+		origins.clear();
+
+		for (glm::ivec3 position : sectionPositions) {
+			auto it = sections.find(position);
+			if (it == sections.end())
+				continue;
+
+			const Section& section = it->second;
+			// indices are relative to the section, 'baseVertex' moves them to where its vertices are
+			GLuint firstIndex = indices.getOffset(section.indices) / sizeof(GLuint);
+			GLint baseVertex = vertices.getOffset(section.vertices) / sizeof(World::ChunkVertex);
+			commands.push_back({ section.indexCount, 1, firstIndex, baseVertex, 0 });
+			origins.push_back(glm::ivec4(position * World::ChunkSection::SIZE, 0));
+		}
+
+		if (commands.empty())
+			return;
+
+		DebugGroup group("chunk sections");
+
+		size_t commandBytes = commands.size() * sizeof(DrawCommand);
+		size_t originBytes = origins.size() * sizeof(glm::ivec4);
+
+		StreamBuffer::Allocation commandStaging{};
+		StreamBuffer::Allocation originStaging{};
+		if (stream.allocate(commandBytes, sizeof(GLuint), commandStaging) && stream.allocate(originBytes, storageAlignment, originStaging)) {
+			std::memcpy(commandStaging.data, commands.data(), commandBytes);
+			std::memcpy(originStaging.data, origins.data(), originBytes);
+
+			RenderState::get().bindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.getBuffer());
+			RenderState::get().bindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, stream.getBuffer(), originStaging.offset, originBytes);
+		} else {
+			if (commands.size() > drawCapacity) {
+				drawCapacity = std::max(commands.size(), drawCapacity * 2);
+
+				GLuint buffers[] = { commandBuffer, originBuffer };
+				RenderState::get().deleteBuffers(2, buffers);
+				commandBuffer = createBuffer(drawCapacity * sizeof(DrawCommand));
+				originBuffer = createBuffer(drawCapacity * sizeof(glm::ivec4));
+			}
+
+			glNamedBufferSubData(commandBuffer, 0, commandBytes, commands.data());
+			glNamedBufferSubData(originBuffer, 0, originBytes, origins.data());
+			commandStaging.offset = 0;
+
+			RenderState::get().bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			RenderState::get().bindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, originBuffer);
+		}
+
+		RenderState::get().bindVertexArray(vao);
+
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*) commandStaging.offset, commands.size(), 0);
+		checkDrawError("glMultiDrawElementsIndirect", GL_TRIANGLES);
+	}
+
+	size_t ChunkRenderer::getSectionCount() const {
+		return sections.size();
+	}
+
+	size_t ChunkRenderer::getDrawCount() const {
+		return commands.size();
+	}
+
+	ArenaStats ChunkRenderer::getVertexStats() const {
+		return vertices.getStats();
+	}
+
+	ArenaStats ChunkRenderer::getIndexStats() const {
+		return indices.getStats();
+	}
+
+	void ChunkRenderer::write(BufferArena& arena, BufferArena::Handle handle, const void* data, size_t size) {
+		StreamBuffer::Allocation staging{};
+		if (!stream.allocate(size, sizeof(GLuint), staging)) {
+			arena.write(handle, data, size);
+			return;
+		}
+
+		std::memcpy(staging.data, data, size);
+		arena.copy(handle, stream.getBuffer(), staging.offset, size);
+	}
+
+	void ChunkRenderer::bindBuffers() {
+		if (boundVertexBuffer != vertices.getBuffer()) {
+			boundVertexBuffer = vertices.getBuffer();
+			glVertexArrayVertexBuffer(vao, 0, boundVertexBuffer, 0, sizeof(World::ChunkVertex));
+		}
+
+		if (boundIndexBuffer != indices.getBuffer()) {
+			boundIndexBuffer = indices.getBuffer();
+			glVertexArrayElementBuffer(vao, boundIndexBuffer);
+		}
+	}
+}
@@ -0,0 +1,220 @@
+#include "chunk.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Minecraft::World {
+	ChunkSection::ChunkSection(BlockId fill) {
+		this->fill(fill);
+	}
+
+	BlockId ChunkSection::getBlock(int index) const {
+		return palette[getEntry(index)];
+	}
+
+	BlockId ChunkSection::setBlock(int index, BlockId block) {
+		uint32_t oldEntry = getEntry(index);
+		BlockId oldBlock = palette[oldEntry];
+		if (oldBlock == block)
+			return oldBlock;
+
+		// might repack, which only compacts free entries, of which there are none when growing
+		uint32_t newEntry = findOrAddPaletteEntry(block);
+
+		setEntry(index, newEntry);
+		counts[newEntry]++;
+
+		if (--counts[oldEntry] == 0) {
+			freeEntries.push_back(oldEntry);
+
+			size_t used = palette.size() - freeEntries.size();
+			if (used == 1) {
+				// only the new block is left
+				fill(block);
+			} else {
+				// only shrink when half of the smaller palette would still be free,
+				// so toggling a single block around a boundary doesn't repack every time
+				uint8_t bits = bitsFor(used * 2);
+				if (bits < bitsPerEntry)
+					repack(bits);
+			}
+		}
+
+		return oldBlock;
+	}
+
+	void ChunkSection::fill(BlockId block) {
+		palette = { block };
+		counts = { VOLUME };
+		freeEntries.clear();
+		freeEntries.shrink_to_fit();
+		data.clear();
+		data.shrink_to_fit();
+		bitsPerEntry = 0;
+	}
+
+	void ChunkSection::setBlocks(std::span<const BlockId, VOLUME> blocks) {
+		palette.clear();
+		counts.clear();
+		freeEntries.clear();
+		freeEntries.shrink_to_fit();
+
+		// neighbouring blocks are usually the same, so remember the last lookup
+		std::vector<uint32_t> entries(VOLUME);
+		BlockId lastBlock = blocks[0];
+		uint32_t lastEntry = 0;
+		palette.push_back(lastBlock);
+		counts.push_back(0);
+
+		for (int i = 0; i < VOLUME; i++) {
+			if (blocks[i] != lastBlock) {
+				lastBlock = blocks[i];
+				auto it = std::find(palette.begin(), palette.end(), lastBlock);
+				lastEntry = it - palette.begin();
+				if (it == palette.end()) {
+					palette.push_back(lastBlock);
+					counts.push_back(0);
+				}
+			}
+
+			entries[i] = lastEntry;
+			counts[lastEntry]++;
+		}
+
+		if (palette.size() == 1) {
+			fill(palette[0]);
+			return;
+		}
+
+		bitsPerEntry = bitsFor(palette.size());
+		data.assign(VOLUME * bitsPerEntry / 64, 0);
+		data.shrink_to_fit();
+		for (int i = 0; i < VOLUME; i++)
+			setEntry(i, entries[i]);
+	}
+
+	bool ChunkSection::isUniform() const {
+		return bitsPerEntry == 0;
+	}
+
+	bool ChunkSection::isEmpty() const {
+		return isUniform() && palette[0] == AIR;
+	}
+
+	size_t ChunkSection::getPaletteSize() const {
+		return palette.size() - freeEntries.size();
+	}
+
+	uint8_t ChunkSection::getBitsPerEntry() const {
+		return bitsPerEntry;
+	}
+
+	size_t ChunkSection::getMemoryUsage() const {
+		return sizeof(ChunkSection)
+			+ palette.capacity() * sizeof(BlockId)
+			+ counts.capacity() * sizeof(uint16_t)
+			+ freeEntries.capacity() * sizeof(uint32_t)
+			+ data.capacity() * sizeof(uint64_t);
+	}
+
+	uint32_t ChunkSection::getEntry(int index) const {
+		if (bitsPerEntry == 0)
+			return 0;
+
+		// bits is a power of two, so the amount of entries per word is one as well
+		int bitsShift = std::countr_zero(bitsPerEntry);
+		int wordShift = 6 - bitsShift;
+
+		uint64_t word = data[index >> wordShift];
+		int offset = (index & ((1 << wordShift) - 1)) << bitsShift;
+
+		return (word >> offset) & ((uint64_t(1) << bitsPerEntry) - 1);
+	}
+
+	void ChunkSection::setEntry(int index, uint32_t entry) {
+		int bitsShift = std::countr_zero(bitsPerEntry);
+		int wordShift = 6 - bitsShift;
+
+		uint64_t& word = data[index >> wordShift];
+		int offset = (index & ((1 << wordShift) - 1)) << bitsShift;
+		uint64_t mask = ((uint64_t(1) << bitsPerEntry) - 1) << offset;
+
+		word = (word & ~mask) | ((uint64_t(entry) << offset) & mask);
+	}
+
+	uint32_t ChunkSection::findOrAddPaletteEntry(BlockId block) {
+		for (uint32_t i = 0; i < palette.size(); i++)
+			if (palette[i] == block && counts[i] > 0)
+				return i;
+
+		if (!freeEntries.empty()) {
+			uint32_t entry = freeEntries.back();
+			freeEntries.pop_back();
+			palette[entry] = block;
+			return entry;
+		}
+
+		palette.push_back(block);
+		counts.push_back(0);
+
+		if (palette.size() > (size_t(1) << bitsPerEntry))
+			repack(bitsFor(palette.size()));
+
+		return palette.size() - 1;
+	}
+
+	void ChunkSection::repack(uint8_t bits) {
+		// compact the palette while moving to the new width, free entries are dropped
+		std::vector<uint32_t> remap(palette.size(), 0);
+		std::vector<BlockId> newPalette;
+		std::vector<uint16_t> newCounts;
+		newPalette.reserve(palette.size() - freeEntries.size());
+		newCounts.reserve(palette.size() - freeEntries.size());
+
+		std::vector<bool> isFree(palette.size(), false);
+		for (uint32_t entry : freeEntries)
+			isFree[entry] = true;
+
+		for (uint32_t i = 0; i < palette.size(); i++) {
+			if (isFree[i])
+				continue;
+
+			remap[i] = newPalette.size();
+			newPalette.push_back(palette[i]);
+			newCounts.push_back(counts[i]);
+		}
+
+		std::vector<uint64_t> oldData = std::move(data);
+		uint8_t oldBits = bitsPerEntry;
+
+		bitsPerEntry = bits;
+		data.assign(VOLUME * bits / 64, 0);
+
+		// a uniform section only refers to entry 0, which is already the value of a zeroed word
+		if (oldBits != 0) {
+			int oldBitsShift = std::countr_zero(oldBits);
+			int oldWordShift = 6 - oldBitsShift;
+			uint64_t oldMask = (uint64_t(1) << oldBits) - 1;
+
+			for (int i = 0; i < VOLUME; i++) {
+				int offset = (i & ((1 << oldWordShift) - 1)) << oldBitsShift;
+				uint32_t entry = (oldData[i >> oldWordShift] >> offset) & oldMask;
+				setEntry(i, remap[entry]);
+			}
+		}
+
+		palette = std::move(newPalette);
+		counts = std::move(newCounts);
+		freeEntries.clear();
+		freeEntries.shrink_to_fit();
+	}
+
+	uint8_t ChunkSection::bitsFor(size_t paletteSize) {
+		if (paletteSize <= 1) return 0;
+		if (paletteSize <= 2) return 1;
+		if (paletteSize <= 4) return 2;
+		if (paletteSize <= 16) return 4;
+		if (paletteSize <= 256) return 8;
+		return 16;
+	}
+}
@@ -0,0 +1,152 @@
+#include "compression.h"
+
+#include <array>
+#include <cstring>
+
+namespace Minecraft::IO {
+	namespace {
+		constexpr size_t MIN_MATCH = 4;
+		/// the format requires the last 5 bytes to be literals, and the last match to start 12 bytes before the end
+		constexpr size_t LAST_LITERALS = 5;
+		constexpr size_t MATCH_FIND_LIMIT = 12;
+		constexpr size_t MAX_OFFSET = 65535;
+
+		constexpr int HASH_BITS = 12;
+
+		uint32_t read32(const uint8_t* data) {
+			uint32_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		uint32_t hash(uint32_t sequence) {
+			return (sequence * 2654435761u) >> (32 - HASH_BITS);
+		}
+
+		void writeLength(std::vector<uint8_t>& out, size_t length) {
+			while (length >= 255) {
+				out.push_back(255);
+				length -= 255;
+			}
+			out.push_back(uint8_t(length));
+		}
+
+		void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+			size_t matchCode = matchLength - MIN_MATCH;
+
+			out.push_back(uint8_t((literalLength >= 15 ? 15 : literalLength) << 4 | (matchCode >= 15 ? 15 : matchCode)));
+			if (literalLength >= 15)
+				writeLength(out, literalLength - 15);
+			out.insert(out.end(), literals, literals + literalLength);
+
+			out.push_back(uint8_t(offset));
+			out.push_back(uint8_t(offset >> 8));
+			if (matchCode >= 15)
+				writeLength(out, matchCode - 15);
+		}
+
+		bool readLength(std::span<const uint8_t> source, size_t& position, size_t& length) {
+			uint8_t byte = 0;
+			do {
+				if (position >= source.size())
+					return false;
+				byte = source[position++];
+				length += byte;
+			} while (byte == 255);
+
+			return true;
+		}
+	}
+
+	std::vector<uint8_t> Compression::compress(std::span<const uint8_t> source) {
+		std::vector<uint8_t> out;
+		out.reserve(source.size() / 2 + 16);
+
+		const uint8_t* data = source.data();
+		size_t size = source.size();
+		size_t anchor = 0;
+
+		if (size > MATCH_FIND_LIMIT) {
+			std::array<int32_t, 1 << HASH_BITS> table;
+			table.fill(-1);
+
+			size_t position = 0;
+			size_t matchLimit = size - LAST_LITERALS;
+			size_t findLimit = size - MATCH_FIND_LIMIT;
+
+			while (position < findLimit) {
+				uint32_t sequence = read32(data + position);
+				uint32_t h = hash(sequence);
+				int32_t candidate = table[h];
+				table[h] = int32_t(position);
+
+				if (candidate < 0 || position - candidate > MAX_OFFSET || read32(data + candidate) != sequence) {
+					position++;
+					continue;
+				}
+
+				size_t length = MIN_MATCH;
+				while (position + length < matchLimit && data[candidate + length] == data[position + length])
+					length++;
+
+				writeSequence(out, data + anchor, position - anchor, position - candidate, length);
+
+				position += length;
+				anchor = position;
+			}
+		}
+
+		// trailing literals, as a sequence without a match
+		size_t literalLength = size - anchor;
+		out.push_back(uint8_t((literalLength >= 15 ? 15 : literalLength) << 4));
+		if (literalLength >= 15)
+			writeLength(out, literalLength - 15);
+		out.insert(out.end(), data + anchor, data + size);
+
+		return out;
+	}
+
+	bool Compression::decompress(std::span<const uint8_t> source, std::span<uint8_t> destination) {
+		size_t in = 0;
+		size_t out = 0;
+
+		while (in < source.size()) {
+			uint8_t token = source[in++];
+
+			size_t literalLength = token >> 4;
+			if (literalLength == 15 && !readLength(source, in, literalLength))
+				return false;
+
+			if (literalLength > source.size() - in || literalLength > destination.size() - out)
+				return false;
+			std::memcpy(destination.data() + out, source.data() + in, literalLength);
+			in += literalLength;
+			out += literalLength;
+
+			// the last sequence only has literals
+			if (in == source.size())
+				break;
+
+			if (source.size() - in < 2)
+				return false;
+			size_t offset = source[in] | source[in + 1] << 8;
+			in += 2;
+			if (offset == 0 || offset > out)
+				return false;
+
+			size_t matchLength = token & 0xF;
+			if (matchLength == 15 && !readLength(source, in, matchLength))
+				return false;
+			matchLength += MIN_MATCH;
+
+			if (matchLength > destination.size() - out)
+				return false;
+
+			// byte by byte, as the match can overlap the bytes it's producing
+			for (size_t i = 0; i < matchLength; i++, out++)
+				destination[out] = destination[out - offset];
+		}
+
+		return out == destination.size();
+	}
+}
@@ -1,4 +1,5 @@
 #include "renderObject.h"
+#include "renderState.h"
 
 #include <iostream>
 
@@ -9,7 +10,7 @@ namespace Minecraft::Assets {
 
 	EBO::EBO(EBO&& other) noexcept {
 		if (ebo != 0)
-			glDeleteBuffers(1, &ebo);
+			Render::RenderState::get().deleteBuffers(1, &ebo);
 
 		this->ebo = other.ebo;
 		this->indicesCount = other.indicesCount;
@@ -21,7 +22,7 @@ namespace Minecraft::Assets {
 	EBO& EBO::operator=(EBO&& other) noexcept {
 		if (this != &other) {
 			if (ebo != 0)
-				glDeleteBuffers(1, &ebo);
+				Render::RenderState::get().deleteBuffers(1, &ebo);
 
 			this->ebo = other.ebo;
 			this->indicesCount = other.indicesCount;
@@ -34,7 +35,7 @@ namespace Minecraft::Assets {
 
 	EBO::~EBO() {
 		if (ebo != 0)
-			glDeleteBuffers(1, &ebo);
+			Render::RenderState::get().deleteBuffers(1, &ebo);
 	}
 
 	EBO EBO::create(const std::function<size_t(GLuint)>& indices) {
@@ -56,11 +57,11 @@ namespace Minecraft::Assets {
 	}
 
 	void EBO::bind() {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+		Render::RenderState::get().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 	}
 
 	void EBO::unbind() {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		Render::RenderState::get().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 
 	size_t EBO::getSize() const {
@@ -0,0 +1,165 @@
+#include "fileWatcher.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+	#include <poll.h>
+	#include <sys/eventfd.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+namespace Minecraft::IO {
+	FileWatch::FileWatch(std::filesystem::path path) : path(std::move(path)) {
+	}
+
+	bool FileWatch::poll() {
+		// only write to the flag when it's set, so polling doesn't bounce the cache line between threads
+		if (!changed.load(std::memory_order_relaxed))
+			return false;
+
+		return changed.exchange(false, std::memory_order_acquire);
+	}
+
+	const std::filesystem::path& FileWatch::getPath() const {
+		return path;
+	}
+
+	FileWatcher::FileWatcher() {
+#ifdef __linux__
+		inotify = inotify_init1(IN_CLOEXEC);
+		wakeUp = eventfd(0, EFD_CLOEXEC);
+		if (inotify < 0 || wakeUp < 0) {
+			std::cerr << "could not start watching files, changes won't be noticed" << std::endl;
+			return;
+		}
+#endif
+
+		thread = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher() {
+		isRunning = false;
+
+#ifdef __linux__
+		if (wakeUp >= 0) {
+			uint64_t value = 1;
+			if (::write(wakeUp, &value, sizeof(value)) < 0)
+				std::cerr << "could not wake up the file watcher, stopping it might hang" << std::endl;
+		}
+#else
+		wakeUp.notify_all();
+#endif
+
+		if (thread.joinable())
+			thread.join();
+
+#ifdef __linux__
+		if (inotify >= 0)
+			close(inotify);
+		if (wakeUp >= 0)
+			close(wakeUp);
+#endif
+	}
+
+	FileWatcher& FileWatcher::get() {
+		static FileWatcher watcher;
+		return watcher;
+	}
+
+	std::shared_ptr<FileWatch> FileWatcher::watch(const std::filesystem::path& _path) {
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::absolute(_path, error).lexically_normal();
+		if (error)
+			path = _path;
+
+		std::lock_guard lock(mutex);
+
+		Entry& entry = files[path];
+		if (std::shared_ptr<FileWatch> watch = entry.watch.lock())
+			return watch;
+
+		std::shared_ptr<FileWatch> watch(new FileWatch(path));
+		entry.watch = watch;
+		entry.lastWriteTime = std::filesystem::last_write_time(path, error);
+
+#ifdef __linux__
+		// files are watched through their directory, as editors often replace the file instead of writing to it
+		std::filesystem::path directory = path.parent_path();
+		if (inotify >= 0 && std::ranges::none_of(directories, [&directory](const auto& pair) { return pair.second == directory; })) {
+			int descriptor = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (descriptor < 0)
+				std::cerr << "could not watch directory '" << directory << "'" << std::endl;
+			else
+				directories[descriptor] = directory;
+		}
+#endif
+
+		return watch;
+	}
+
+	void FileWatcher::run() {
+#ifdef __linux__
+		alignas(inotify_event) char buffer[4096];
+
+		while (isRunning) {
+			pollfd descriptors[] = {
+				{ inotify, POLLIN, 0 },
+				{ wakeUp, POLLIN, 0 },
+			};
+			if (::poll(descriptors, 2, -1) < 0 || !isRunning)
+				continue;
+			if (!(descriptors[0].revents & POLLIN))
+				continue;
+
+			ssize_t length = read(inotify, buffer, sizeof(buffer));
+			if (length <= 0)
+				continue;
+
+			std::lock_guard lock(mutex);
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_IGNORED) {
+					directories.erase(event->wd);
+					continue;
+				}
+
+				auto it = directories.find(event->wd);
+				if (it != directories.end() && event->len > 0)
+					notify(it->second / event->name);
+			}
+		}
+#else
+		std::unique_lock lock(mutex);
+		while (isRunning) {
+			wakeUp.wait_for(lock, POLL_INTERVAL);
+
+			for (auto& [path, entry] : files) {
+				if (entry.watch.expired())
+					continue;
+
+				std::error_code error;
+				std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(path, error);
+				if (!error && lastWriteTime != entry.lastWriteTime) {
+					entry.lastWriteTime = lastWriteTime;
+					notify(path);
+				}
+			}
+		}
+#endif
+	}
+
+	void FileWatcher::notify(const std::filesystem::path& path) {
+		auto it = files.find(path);
+		if (it == files.end())
+			return;
+
+		if (std::shared_ptr<FileWatch> watch = it->second.watch.lock())
+			watch->changed.store(true, std::memory_order_release);
+		else
+			files.erase(it);
+	}
+}
@@ -0,0 +1,43 @@
+#include "framebuffer.h"
+
+#include <iostream>
+
+namespace Minecraft::Assets {
+	Framebuffer::Framebuffer(glm::ivec2 size) : size(size) {
+		// renderbuffers, as nothing samples the attachments
+		glCreateRenderbuffers(1, &color);
+		glNamedRenderbufferStorage(color, GL_RGBA8, size.x, size.y);
+		glCreateRenderbuffers(1, &depth);
+		glNamedRenderbufferStorage(depth, GL_DEPTH_COMPONENT24, size.x, size.y);
+
+		glCreateFramebuffers(1, &framebuffer);
+		glNamedFramebufferRenderbuffer(framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+		glNamedFramebufferRenderbuffer(framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+		if (!isComplete())
+			std::cerr << "framebuffer of " << size.x << "x" << size.y << " is incomplete" << std::endl;
+	}
+
+	Framebuffer::~Framebuffer() {
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &color);
+		glDeleteRenderbuffers(1, &depth);
+	}
+
+	void Framebuffer::bind() {
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+		glViewport(0, 0, size.x, size.y);
+	}
+
+	void Framebuffer::unbind() {
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	}
+
+	bool Framebuffer::isComplete() const {
+		return glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	glm::ivec2 Framebuffer::getSize() const {
+		return size;
+	}
+}
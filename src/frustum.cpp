@@ -0,0 +1,101 @@
+#include "frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MINECRAFT_FRUSTUM_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace Minecraft::Render {
+	Frustum::Frustum(const glm::mat4& viewProjection) {
+		// glm is column major, so the rows of the matrix are strided
+		auto row = [&viewProjection](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+		for (int axis = 0; axis < 3; axis++) {
+			planes[axis * 2] = row(3) + row(axis);
+			planes[axis * 2 + 1] = row(3) - row(axis);
+		}
+	}
+
+	bool Frustum::isVisible(const AABB& box) const {
+		for (const glm::vec4& plane : planes) {
+			// the corner furthest along the normal, if that one is behind the plane the whole box is
+			float x = plane.x > 0 ? box.max.x : box.min.x;
+			float y = plane.y > 0 ? box.max.y : box.min.y;
+			float z = plane.z > 0 ? box.max.z : box.min.z;
+			if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	size_t Frustum::cull(std::span<const AABB> boxes, std::span<uint8_t> visible) const {
+		size_t count = 0;
+		size_t i = 0;
+
+#ifdef MINECRAFT_FRUSTUM_SSE2
+		__m128 normalX[6];
+		__m128 normalY[6];
+		__m128 normalZ[6];
+		__m128 distance[6];
+		for (size_t p = 0; p < planes.size(); p++) {
+			normalX[p] = _mm_set1_ps(planes[p].x);
+			normalY[p] = _mm_set1_ps(planes[p].y);
+			normalZ[p] = _mm_set1_ps(planes[p].z);
+			distance[p] = _mm_set1_ps(planes[p].w);
+		}
+
+		for (; i + 4 <= boxes.size(); i += 4) {
+			// 4 boxes are 6 registers of consecutive floats, shuffled so every lane holds one box
+			const float* f = &boxes[i].min.x;
+			__m128 r0 = _mm_loadu_ps(f);
+			__m128 r1 = _mm_loadu_ps(f + 4);
+			__m128 r2 = _mm_loadu_ps(f + 8);
+			__m128 r3 = _mm_loadu_ps(f + 12);
+			__m128 r4 = _mm_loadu_ps(f + 16);
+			__m128 r5 = _mm_loadu_ps(f + 20);
+
+			__m128 minXY01 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 2, 1, 0));
+			__m128 minXY23 = _mm_shuffle_ps(r3, r4, _MM_SHUFFLE(3, 2, 1, 0));
+			__m128 minZMaxX01 = _mm_shuffle_ps(r0, r2, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128 minZMaxX23 = _mm_shuffle_ps(r3, r5, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128 maxYZ01 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(3, 2, 1, 0));
+			__m128 maxYZ23 = _mm_shuffle_ps(r4, r5, _MM_SHUFFLE(3, 2, 1, 0));
+
+			__m128 minX = _mm_shuffle_ps(minXY01, minXY23, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 minY = _mm_shuffle_ps(minXY01, minXY23, _MM_SHUFFLE(3, 1, 3, 1));
+			__m128 minZ = _mm_shuffle_ps(minZMaxX01, minZMaxX23, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 maxX = _mm_shuffle_ps(minZMaxX01, minZMaxX23, _MM_SHUFFLE(3, 1, 3, 1));
+			__m128 maxY = _mm_shuffle_ps(maxYZ01, maxYZ23, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 maxZ = _mm_shuffle_ps(maxYZ01, maxYZ23, _MM_SHUFFLE(3, 1, 3, 1));
+
+			// all bits set in lanes that are behind any plane
+			__m128 outside = _mm_setzero_ps();
+			for (size_t p = 0; p < planes.size(); p++) {
+				// the normal is the same for every lane, so the corner is picked without a blend
+				__m128 x = planes[p].x > 0 ? maxX : minX;
+				__m128 y = planes[p].y > 0 ? maxY : minY;
+				__m128 z = planes[p].z > 0 ? maxZ : minZ;
+
+				// same order of operations as the scalar test, so both give the same results
+				__m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX[p], x), _mm_mul_ps(normalY[p], y)), _mm_mul_ps(normalZ[p], z)), distance[p]);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(d, _mm_setzero_ps()));
+			}
+
+			int mask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; lane++) {
+				bool isInside = !(mask & 1 << lane);
+				visible[i + lane] = isInside;
+				count += isInside;
+			}
+		}
+#endif
+
+		for (; i < boxes.size(); i++) {
+			visible[i] = isVisible(boxes[i]);
+			count += visible[i];
+		}
+
+		return count;
+	}
+}
@@ -0,0 +1,134 @@
+#include "glDebug.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Minecraft::Render {
+	namespace {
+#ifdef MINECRAFT_GL_DEBUG
+		std::string_view sourceName(GLenum source) {
+			switch (source) {
+				case GL_DEBUG_SOURCE_API: return "api";
+				case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+				case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+				case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+				case GL_DEBUG_SOURCE_APPLICATION: return "application";
+				default: return "other";
+			}
+		}
+
+		std::string_view typeName(GLenum type) {
+			switch (type) {
+				case GL_DEBUG_TYPE_ERROR: return "error";
+				case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+				case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behaviour";
+				case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+				case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+				case GL_DEBUG_TYPE_MARKER: return "marker";
+				default: return "other";
+			}
+		}
+
+		std::string_view severityName(GLenum severity) {
+			switch (severity) {
+				case GL_DEBUG_SEVERITY_HIGH: return "high";
+				case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+				case GL_DEBUG_SEVERITY_LOW: return "low";
+				default: return "notification";
+			}
+		}
+
+		/// names of the debug groups currently pushed, messages are synchronous so this is only used by the GL thread
+		std::vector<std::string> groups;
+
+		void GLAPIENTRY onDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void*) {
+			// the driver announces every push and pop, which is how the groups are known here
+			if (type == GL_DEBUG_TYPE_PUSH_GROUP) {
+				groups.emplace_back(message, length);
+				return;
+			}
+			if (type == GL_DEBUG_TYPE_POP_GROUP) {
+				if (!groups.empty())
+					groups.pop_back();
+				return;
+			}
+			// drivers are very chatty about things like buffer placement
+			if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+				return;
+
+			std::cerr << "opengl " << typeName(type) << " (" << severityName(severity) << ", " << sourceName(source) << " " << id << ")";
+			for (const std::string& group : groups)
+				std::cerr << " in '" << group << "'";
+			std::cerr << ": " << std::string_view(message, length) << std::endl;
+		}
+#endif
+	}
+
+	bool enableDebugOutput() {
+#ifdef MINECRAFT_GL_DEBUG
+		if (!GLEW_KHR_debug && !GLEW_VERSION_4_3)
+			return false;
+
+		glEnable(GL_DEBUG_OUTPUT);
+		// reported during the call that caused them, so the group stack is right and a breakpoint shows the caller
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		glDebugMessageCallback(onDebugMessage, nullptr);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void setLabel(GLenum identifier, GLuint object, std::string_view label) {
+#ifdef MINECRAFT_GL_DEBUG
+		glObjectLabel(identifier, object, label.size(), label.data());
+#endif
+	}
+
+	void reportDrawError(GLenum error, std::string_view function, GLenum shape) {
+		if (error == GL_INVALID_ENUM) {
+			std::cerr << "Rendershape is not valid, must be one of " <<
+				"'GL_POINTS', 'GL_LINE_STRIP', 'GL_LINE_LOOP', 'GL_LINES', 'GL_TRIANGLE_STRIP', 'GL_TRIANGLE_FAN', 'GL_TRIANGLES', 'GL_PATCHES'";
+			int version[] = { 3, 0 };
+			glGetIntegerv(GL_MAJOR_VERSION, &version[0]);
+			glGetIntegerv(GL_MINOR_VERSION, &version[1]);
+			if ((version[0] == 3 && version[1] >= 2) || version[0] > 3)
+				std::cerr << ", 'GL_LINE_STRIP_ADJACENCY', 'GL_LINES_ADJACENCY', 'GL_TRIANGLE_STRIP_ADJACENCY', 'GL_TRIANGLES_ADJACENCY'";
+
+			std::cerr << std::endl;
+		} else if (error == GL_INVALID_OPERATION) {
+			bool isMapped = false;
+			glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_MAPPED, (int*) &isMapped);
+
+			if (isMapped)
+				std::cerr << "Buffer is currently mapped for data access, and cannot be rendered" << std::endl;
+			else {
+				GLenum geometryShape = 0;
+				GLint currentProgram = 0;
+
+				glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+				glGetProgramiv(currentProgram, GL_GEOMETRY_INPUT_TYPE, (int*) &geometryShape);
+				if (geometryShape != shape)
+					std::cerr << "A geometry shader is present, and requires a certain rendershape" << std::endl;
+				else
+					std::cerr << "'" << function << "' caused 'GL_INVALID_OPERATION' error with unknown cause" << std::endl;
+			}
+		} else if (error != GL_NO_ERROR)
+			std::cerr << "'" << function << "' caused unchecked error " << error << std::endl;
+	}
+
+	DebugGroup::DebugGroup(std::string_view name) {
+#ifdef MINECRAFT_GL_DEBUG
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, name.size(), name.data());
+#endif
+	}
+
+	DebugGroup::~DebugGroup() {
+#ifdef MINECRAFT_GL_DEBUG
+		glPopDebugGroup();
+#endif
+	}
+}
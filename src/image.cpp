@@ -0,0 +1,147 @@
+#include "image.h"
+#include "qoi.h"
+#include "mappedFile.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Minecraft::Assets {
+	Image::Image(glm::ivec2 size) : size(size), pixels(size_t(size.x) * size.y * 4, 0) {}
+
+	Image::Image(const uint8_t* pixels, glm::ivec2 size) : size(size), pixels(pixels, pixels + size_t(size.x) * size.y * 4) {}
+
+	std::shared_ptr<Image> Image::load(const std::filesystem::path& path) {
+		if (!std::filesystem::exists(path)) {
+			std::cerr << "file '" << path.filename() << "' at '" << path.parent_path() << "' does not exist" << std::endl;
+			return nullptr;
+		}
+
+		// decoded straight from the mapping, without copying the file into memory first
+		std::shared_ptr<IO::MappedFile> file = IO::MappedFile::open(path);
+		if (!file)
+			return nullptr;
+
+		std::shared_ptr<Image> image = decode(file->getData());
+		if (!image)
+			std::cerr << "couldn't load image '" << path << "'" << std::endl;
+		return image;
+	}
+
+	std::shared_ptr<Image> Image::decode(std::span<const uint8_t> data) {
+		if (Qoi::isQoi(data))
+			return Qoi::decode(data);
+
+		int width = 0;
+		int height = 0;
+		uint8_t* pixels = stbi_load_from_memory(data.data(), data.size(), &width, &height, nullptr, 4);
+		if (!pixels) {
+			std::cerr << "couldn't decode image: '" << stbi_failure_reason() << "'" << std::endl;
+			return nullptr;
+		}
+
+		std::shared_ptr<Image> image = std::make_shared<Image>(pixels, glm::ivec2(width, height));
+		stbi_image_free(pixels);
+		return image;
+	}
+
+	glm::ivec2 Image::getSize() const {
+		return size;
+	}
+
+	bool Image::isEmpty() const {
+		return pixels.empty();
+	}
+
+	uint8_t* Image::getData() {
+		return pixels.data();
+	}
+
+	const uint8_t* Image::getData() const {
+		return pixels.data();
+	}
+
+	size_t Image::getByteSize() const {
+		return pixels.size();
+	}
+
+	Image Image::resized(glm::ivec2 newSize) const {
+		if (newSize == size)
+			return *this;
+
+		Image result(newSize);
+		for (int y = 0; y < newSize.y; y++) {
+			int sourceY = y * size.y / newSize.y;
+			for (int x = 0; x < newSize.x; x++) {
+				int sourceX = x * size.x / newSize.x;
+				std::memcpy(&result.pixels[(size_t(y) * newSize.x + x) * 4], &pixels[(size_t(sourceY) * size.x + sourceX) * 4], 4);
+			}
+		}
+		return result;
+	}
+
+	Image Image::cropped(glm::ivec2 offset, glm::ivec2 cropSize) const {
+		Image result(cropSize);
+		for (int y = 0; y < cropSize.y; y++)
+			std::memcpy(&result.pixels[size_t(y) * cropSize.x * 4], &pixels[(size_t(offset.y + y) * size.x + offset.x) * 4], size_t(cropSize.x) * 4);
+		return result;
+	}
+
+	std::vector<Image> Image::split(glm::ivec2 tileSize) const {
+		std::vector<Image> tiles;
+		glm::ivec2 count = size / tileSize;
+		tiles.reserve(size_t(count.x) * count.y);
+
+		for (int y = 0; y < count.y; y++)
+			for (int x = 0; x < count.x; x++)
+				tiles.push_back(cropped(glm::ivec2(x, y) * tileSize, tileSize));
+
+		return tiles;
+	}
+
+	Image Image::downsampled() const {
+		glm::ivec2 newSize = glm::max(size / 2, glm::ivec2(1));
+		Image result(newSize);
+
+		for (int y = 0; y < newSize.y; y++) {
+			for (int x = 0; x < newSize.x; x++) {
+				uint32_t color[3] = { 0, 0, 0 };
+				uint32_t plainColor[3] = { 0, 0, 0 };
+				uint32_t alpha = 0;
+
+				// clamped, so a side of 1 averages the same texel twice
+				for (int dy = 0; dy < 2; dy++) {
+					for (int dx = 0; dx < 2; dx++) {
+						int sourceX = std::min(x * 2 + dx, size.x - 1);
+						int sourceY = std::min(y * 2 + dy, size.y - 1);
+						const uint8_t* texel = &pixels[(size_t(sourceY) * size.x + sourceX) * 4];
+
+						for (int i = 0; i < 3; i++) {
+							color[i] += texel[i] * texel[3];
+							plainColor[i] += texel[i];
+						}
+						alpha += texel[3];
+					}
+				}
+
+				uint8_t* texel = &result.pixels[(size_t(y) * newSize.x + x) * 4];
+				for (int i = 0; i < 3; i++)
+					// fully transparent texels keep their color, so it's still right when alpha is blended in again
+					texel[i] = alpha > 0 ? (color[i] + alpha / 2) / alpha : (plainColor[i] + 2) / 4;
+				texel[3] = (alpha + 2) / 4;
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<Image> Image::mipChain() const {
+		std::vector<Image> levels = { *this };
+		while (levels.back().size.x > 1 || levels.back().size.y > 1)
+			levels.push_back(levels.back().downsampled());
+
+		return levels;
+	}
+}
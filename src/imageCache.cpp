@@ -0,0 +1,82 @@
+#include "imageCache.h"
+#include "binary.h"
+#include "cacheEntry.h"
+
+#include <iostream>
+#include <vector>
+
+namespace Minecraft::Assets {
+	namespace {
+		constexpr std::string_view MAGIC = "MCIC";
+		constexpr uint8_t VERSION = 2;
+		/// modification time, source size, width, height
+		constexpr size_t METADATA_SIZE = 8 + 8 + 4 + 4;
+	}
+
+	ImageCache::ImageCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+	std::shared_ptr<Image> ImageCache::load(const std::filesystem::path& path) {
+		std::error_code error;
+		uint64_t modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		uint64_t size = 0;
+		if (!error)
+			size = std::filesystem::file_size(path, error);
+		if (error) {
+			std::cerr << "file '" << path.filename() << "' at '" << path.parent_path() << "' does not exist" << std::endl;
+			return nullptr;
+		}
+
+		std::string source = path.lexically_normal().generic_string();
+		std::filesystem::path entry = getEntryPath(source);
+
+		if (std::shared_ptr<Image> image = read(entry, source, modified, size)) {
+			hits++;
+			return image;
+		}
+
+		misses++;
+		std::shared_ptr<Image> image = Image::load(path);
+		if (image)
+			write(entry, source, modified, size, *image);
+		return image;
+	}
+
+	ImageCacheStats ImageCache::getStats() const {
+		return { hits.load(), misses.load() };
+	}
+
+	std::filesystem::path ImageCache::getEntryPath(const std::string& source) const {
+		return IO::CacheEntry::getPath(directory, source, "rgba");
+	}
+
+	std::shared_ptr<Image> ImageCache::read(const std::filesystem::path& entry, const std::string& source, uint64_t modified, uint64_t size) const {
+		std::shared_ptr<IO::CacheEntry> cached = IO::CacheEntry::read(entry, MAGIC, VERSION, source);
+		if (!cached)
+			return nullptr;
+
+		std::span<const uint8_t> metadata = cached->getMetadata();
+		if (metadata.size() != METADATA_SIZE)
+			return nullptr;
+
+		if (IO::readLittleEndian<uint64_t>(metadata, 0) != modified || IO::readLittleEndian<uint64_t>(metadata, 8) != size)
+			return nullptr;
+
+		glm::ivec2 imageSize(IO::readLittleEndian<uint32_t>(metadata, 16), IO::readLittleEndian<uint32_t>(metadata, 20));
+		std::span<const uint8_t> pixels = cached->getPayload();
+		if (pixels.size() != size_t(imageSize.x) * imageSize.y * 4)
+			return nullptr;
+
+		return std::make_shared<Image>(pixels.data(), imageSize);
+	}
+
+	void ImageCache::write(const std::filesystem::path& entry, const std::string& source, uint64_t modified, uint64_t size, const Image& image) {
+		std::vector<uint8_t> metadata;
+		metadata.reserve(METADATA_SIZE);
+		IO::writeLittleEndian(metadata, modified);
+		IO::writeLittleEndian(metadata, size);
+		IO::writeLittleEndian<uint32_t>(metadata, image.getSize().x);
+		IO::writeLittleEndian<uint32_t>(metadata, image.getSize().y);
+
+		IO::CacheEntry::write(entry, MAGIC, VERSION, source, metadata, { image.getData(), image.getByteSize() });
+	}
+}
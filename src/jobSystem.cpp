@@ -0,0 +1,269 @@
+#include "jobSystem.h"
+#include "profiler.h"
+
+#include <iostream>
+#include <exception>
+#include <string>
+
+namespace Minecraft::Jobs {
+	namespace {
+		/// index of the worker the current thread belongs to, only valid when 'currentSystem' matches
+		thread_local size_t currentWorker = 0;
+		thread_local const JobSystem* currentSystem = nullptr;
+
+		int64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+	}
+
+	JobHandle::JobHandle(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+	bool JobHandle::cancel() {
+		if (!state)
+			return false;
+
+		Status expected = Status::PENDING;
+		return state->status.compare_exchange_strong(expected, Status::CANCELLED) || expected == Status::CANCELLED;
+	}
+
+	bool JobHandle::isValid() const {
+		return state != nullptr;
+	}
+
+	bool JobHandle::isCancelled() const {
+		return state && state->status == Status::CANCELLED;
+	}
+
+	bool JobHandle::isDone() const {
+		return state && state->status == Status::DONE;
+	}
+
+	JobSystem::JobSystem(size_t workerCount) {
+		workerCount = std::max<size_t>(workerCount, 1);
+
+		statsStart = now();
+
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; i++)
+			workers.push_back(std::make_unique<Worker>());
+
+		// only start the threads after every worker exists, as they immediately try to steal from each other
+		for (size_t i = 0; i < workerCount; i++)
+			workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard lock(sleepMutex);
+			isRunning = false;
+		}
+		sleepCondition.notify_all();
+
+		for (std::unique_ptr<Worker>& worker : workers)
+			if (worker->thread.joinable())
+				worker->thread.join();
+	}
+
+	JobHandle JobSystem::submit(std::function<void()> function, Priority priority) {
+		std::shared_ptr<JobHandle::State> state = std::make_shared<JobHandle::State>();
+
+		// jobs spawned from a worker stay on that worker, they likely share data with the job that spawned them
+		size_t index = currentSystem == this ? currentWorker : nextWorker++ % workers.size();
+
+		// counted before the job can be taken, so another worker finishing it first can't make the counters wrap around
+		unfinished++;
+		{
+			// makes sure a worker that is about to sleep sees the new job
+			std::lock_guard lock(sleepMutex);
+			queued++;
+		}
+		{
+			Worker& worker = *workers[index];
+			std::lock_guard lock(worker.mutex);
+			worker.queues[static_cast<size_t>(priority)].push_back({ std::move(function), state });
+		}
+		sleepCondition.notify_one();
+
+		return JobHandle(state);
+	}
+
+	void JobSystem::submitToMainThread(std::function<void()> job) {
+		std::lock_guard lock(mainThreadMutex);
+		mainThreadJobs.push_back(std::move(job));
+	}
+
+	size_t JobSystem::runMainThreadJobs(std::chrono::nanoseconds budget) {
+		int64_t start = now();
+		size_t count = 0;
+
+		while (true) {
+			std::function<void()> job;
+			{
+				std::lock_guard lock(mainThreadMutex);
+				if (mainThreadJobs.empty())
+					break;
+
+				job = std::move(mainThreadJobs.front());
+				mainThreadJobs.pop_front();
+			}
+
+			job();
+			count++;
+
+			if (now() - start >= budget.count())
+				break;
+		}
+
+		return count;
+	}
+
+	void JobSystem::waitIdle() {
+		while (unfinished > 0) {
+			Job job;
+			// jobs run by the waiting thread are counted as work of the first worker
+			if (take(workers.size(), job))
+				run(*workers[0], job);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	size_t JobSystem::getWorkerCount() const {
+		return workers.size();
+	}
+
+	size_t JobSystem::getPendingCount() const {
+		return unfinished;
+	}
+
+	size_t JobSystem::getMainThreadPendingCount() const {
+		std::lock_guard lock(mainThreadMutex);
+		return mainThreadJobs.size();
+	}
+
+	std::vector<WorkerStats> JobSystem::getStats() const {
+		int64_t elapsed = std::max<int64_t>(now() - statsStart, 1);
+
+		std::vector<WorkerStats> stats;
+		stats.reserve(workers.size());
+		for (const std::unique_ptr<Worker>& worker : workers) {
+			WorkerStats& stat = stats.emplace_back();
+			stat.jobsExecuted = worker->jobsExecuted;
+			stat.jobsStolen = worker->jobsStolen;
+			stat.jobsCancelled = worker->jobsCancelled;
+			stat.busyTime = std::chrono::nanoseconds(worker->busyNanoseconds);
+			stat.utilisation = std::min((float) worker->busyNanoseconds / elapsed, 1.0f);
+		}
+
+		return stats;
+	}
+
+	void JobSystem::resetStats() {
+		for (std::unique_ptr<Worker>& worker : workers) {
+			worker->jobsExecuted = 0;
+			worker->jobsStolen = 0;
+			worker->jobsCancelled = 0;
+			worker->busyNanoseconds = 0;
+		}
+
+		statsStart = now();
+	}
+
+	void JobSystem::workerLoop(size_t index) {
+		currentWorker = index;
+		currentSystem = this;
+		Profiling::Profiler::get().setThreadName("worker " + std::to_string(index));
+
+		Worker& worker = *workers[index];
+		while (isRunning) {
+			Job job;
+			if (take(index, job)) {
+				run(worker, job);
+				continue;
+			}
+
+			std::unique_lock lock(sleepMutex);
+			sleepCondition.wait(lock, [this]() { return queued > 0 || !isRunning; });
+		}
+
+		currentSystem = nullptr;
+	}
+
+	bool JobSystem::take(size_t index, Job& job) {
+		// a higher priority job of another worker goes before a lower priority job of this one
+		for (size_t priority = 0; priority < PRIORITY_COUNT; priority++)
+			if (popOwn(index, priority, job) || steal(index, priority, job))
+				return true;
+
+		return false;
+	}
+
+	bool JobSystem::popOwn(size_t index, size_t priority, Job& job) {
+		if (index >= workers.size())
+			return false;
+
+		Worker& worker = *workers[index];
+		std::lock_guard lock(worker.mutex);
+
+		std::deque<Job>& queue = worker.queues[priority];
+		if (queue.empty())
+			return false;
+
+		job = std::move(queue.back());
+		queue.pop_back();
+		queued--;
+
+		return true;
+	}
+
+	bool JobSystem::steal(size_t thief, size_t priority, Job& job) {
+		// 'thief' can be out of range for threads that aren't workers, in which case every worker is a victim
+		for (size_t offset = 1; offset <= workers.size(); offset++) {
+			size_t index = (thief + offset) % workers.size();
+			if (index == thief)
+				continue;
+
+			Worker& victim = *workers[index];
+			std::lock_guard lock(victim.mutex);
+
+			std::deque<Job>& queue = victim.queues[priority];
+			if (queue.empty())
+				continue;
+
+			job = std::move(queue.front());
+			queue.pop_front();
+			queued--;
+
+			if (thief < workers.size())
+				workers[thief]->jobsStolen++;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::run(Worker& worker, Job& job) {
+		JobHandle::Status expected = JobHandle::Status::PENDING;
+		if (!job.state->status.compare_exchange_strong(expected, JobHandle::Status::RUNNING)) {
+			worker.jobsCancelled++;
+			unfinished--;
+			return;
+		}
+
+		int64_t start = now();
+		try {
+			Profiling::CpuZone zone("job");
+			job.function();
+		} catch (const std::exception& e) {
+			std::cerr << "job threw an exception: " << e.what() << std::endl;
+		} catch (...) {
+			std::cerr << "job threw an unknown exception" << std::endl;
+		}
+		worker.busyNanoseconds += now() - start;
+		worker.jobsExecuted++;
+
+		job.state->status = JobHandle::Status::DONE;
+		unfinished--;
+	}
+}
@@ -0,0 +1,326 @@
+#include "lighting.h"
+#include "block.h"
+
+#include <algorithm>
+
+namespace Minecraft::World {
+	namespace {
+		constexpr int SIZE = ChunkSection::SIZE;
+
+		constexpr std::array<LightType, 2> LIGHT_TYPES = { LightType::BLOCK, LightType::SKY };
+
+		/// breadth first propagation of one type of light within a region
+		/// removals run first, so the additions can fill in what they left dark
+		class Propagator {
+		public:
+			Propagator(LightRegion& region, LightType type) : region(region), type(type) {}
+
+			/// 'position' spreads its current light to its neighbours
+			void add(glm::ivec3 position) {
+				additions.push_back(position);
+			}
+
+			/// 'position' used to have 'level', and was set to 0 already
+			void remove(glm::ivec3 position, uint8_t level) {
+				removals.push_back({ position, level });
+			}
+
+			void run() {
+				// vectors are used as queues, as they're cheaper to append to and read in order than deques
+				for (size_t i = 0; i < removals.size(); i++) {
+					auto [position, level] = removals[i];
+
+					for (int f = 0; f < FACE_COUNT; f++) {
+						Face face = static_cast<Face>(f);
+						glm::ivec3 neighbour = position + faceNormal(face);
+						if (!region.contains(neighbour))
+							continue;
+
+						uint8_t current = region.getLight(type, neighbour);
+						if (current == 0)
+							continue;
+
+						// darker than what was removed means it was lit from here, as does full sky light below full sky light
+						if (current < level || (isSkyDown(face, level) && current == SectionLight::MAX)) {
+							region.setLight(type, neighbour, 0);
+							removals.push_back({ neighbour, current });
+
+							// light sources lose the light of others, but not their own
+							if (uint8_t emitted = getEmitted(neighbour)) {
+								region.setLight(type, neighbour, emitted);
+								additions.push_back(neighbour);
+							}
+						} else {
+							// lit by something else, which can spread back into what was removed
+							additions.push_back(neighbour);
+						}
+					}
+				}
+
+				for (size_t i = 0; i < additions.size(); i++) {
+					glm::ivec3 position = additions[i];
+					uint8_t level = region.getLight(type, position);
+					if (level <= 1)
+						continue;
+
+					for (int f = 0; f < FACE_COUNT; f++) {
+						Face face = static_cast<Face>(f);
+						glm::ivec3 neighbour = position + faceNormal(face);
+						if (!region.contains(neighbour) || BlockRegistry::isOpaque(region.getBlock(neighbour)))
+							continue;
+
+						uint8_t next = isSkyDown(face, level) ? level : uint8_t(level - 1);
+						if (region.getLight(type, neighbour) >= next)
+							continue;
+
+						region.setLight(type, neighbour, next);
+						additions.push_back(neighbour);
+					}
+				}
+
+				removals.clear();
+				additions.clear();
+			}
+
+		private:
+			struct Removal {
+				glm::ivec3 position;
+				uint8_t level;
+			};
+
+			bool isSkyDown(Face face, uint8_t level) const {
+				return type == LightType::SKY && face == Face::NEG_Y && level == SectionLight::MAX;
+			}
+
+			uint8_t getEmitted(glm::ivec3 position) const {
+				return type == LightType::BLOCK ? BlockRegistry::getLight(region.getBlock(position)) : 0;
+			}
+
+			LightRegion& region;
+			LightType type;
+
+			std::vector<Removal> removals;
+			std::vector<glm::ivec3> additions;
+		};
+	}
+
+	LightRegion::LightRegion(glm::ivec2 center, std::array<std::shared_ptr<Chunk>, CHUNK_COUNT> chunks) : center(center), chunks(std::move(chunks)) {}
+
+	glm::ivec2 LightRegion::getCenter() const {
+		return center;
+	}
+
+	Chunk* LightRegion::getChunk(glm::ivec2 chunkPosition) const {
+		glm::ivec2 offset = chunkPosition - center + 1;
+		if (offset.x < 0 || offset.y < 0 || offset.x >= WIDTH || offset.y >= WIDTH)
+			return nullptr;
+
+		return chunks[offset.x + offset.y * WIDTH].get();
+	}
+
+	std::vector<glm::ivec2> LightRegion::getChangedChunks() const {
+		std::vector<glm::ivec2> positions;
+		for (int i = 0; i < CHUNK_COUNT; i++)
+			if (changed[i])
+				positions.push_back(center + glm::ivec2(i % WIDTH, i / WIDTH) - 1);
+
+		return positions;
+	}
+
+	glm::ivec3 LightRegion::toLocal(glm::ivec3 worldPosition) const {
+		return worldPosition - glm::ivec3((center.x - 1) * ChunkSection::SIZE, 0, (center.y - 1) * ChunkSection::SIZE);
+	}
+
+	bool LightRegion::contains(glm::ivec3 position) const {
+		if (position.x < 0 || position.z < 0 || position.x >= SIZE || position.z >= SIZE || position.y < 0 || position.y >= Chunk::HEIGHT)
+			return false;
+
+		return chunks[position.x / ChunkSection::SIZE + position.z / ChunkSection::SIZE * WIDTH] != nullptr;
+	}
+
+	BlockId LightRegion::getBlock(glm::ivec3 position) const {
+		return chunkAt(position).getBlock(position.x % ChunkSection::SIZE, position.y, position.z % ChunkSection::SIZE);
+	}
+
+	void LightRegion::setBlock(glm::ivec3 position, BlockId block) {
+		chunkAt(position).setBlock(position.x % ChunkSection::SIZE, position.y, position.z % ChunkSection::SIZE, block);
+		markChanged(position);
+	}
+
+	uint8_t LightRegion::getLight(LightType type, glm::ivec3 position) const {
+		return chunkAt(position).getLight(type, position.x % ChunkSection::SIZE, position.y, position.z % ChunkSection::SIZE);
+	}
+
+	void LightRegion::setLight(LightType type, glm::ivec3 position, uint8_t level) {
+		chunkAt(position).setLight(type, position.x % ChunkSection::SIZE, position.y, position.z % ChunkSection::SIZE, level);
+		markChanged(position);
+	}
+
+	Chunk& LightRegion::chunkAt(glm::ivec3 position) const {
+		return *chunks[position.x / ChunkSection::SIZE + position.z / ChunkSection::SIZE * WIDTH];
+	}
+
+	void LightRegion::markChanged(glm::ivec3 position) {
+		glm::ivec2 chunk(position.x / ChunkSection::SIZE, position.z / ChunkSection::SIZE);
+		glm::ivec2 local(position.x % ChunkSection::SIZE, position.z % ChunkSection::SIZE);
+
+		auto mark = [this](glm::ivec2 chunk) {
+			if (chunk.x >= 0 && chunk.y >= 0 && chunk.x < WIDTH && chunk.y < WIDTH && chunks[chunk.x + chunk.y * WIDTH])
+				changed[chunk.x + chunk.y * WIDTH] = true;
+		};
+
+		mark(chunk);
+		if (local.x == 0)
+			mark(chunk - glm::ivec2(1, 0));
+		if (local.x == ChunkSection::SIZE - 1)
+			mark(chunk + glm::ivec2(1, 0));
+		if (local.y == 0)
+			mark(chunk - glm::ivec2(0, 1));
+		if (local.y == ChunkSection::SIZE - 1)
+			mark(chunk + glm::ivec2(0, 1));
+	}
+
+	void Lighting::lightChunk(Chunk& chunk) {
+		// the chunk is only borrowed, the region doesn't own it
+		std::array<std::shared_ptr<Chunk>, LightRegion::CHUNK_COUNT> chunks = {};
+		chunks[LightRegion::CHUNK_COUNT / 2] = std::shared_ptr<Chunk>(&chunk, [](Chunk*) {});
+		LightRegion region(chunk.getPosition(), std::move(chunks));
+
+		// sky light is full down to the first opaque block of each column, and dark below it
+		std::array<int, ChunkSection::AREA> heights = {};
+		for (int z = 0; z < SIZE; z++) {
+			for (int x = 0; x < SIZE; x++) {
+				int y = Chunk::HEIGHT;
+				while (y > 0 && !BlockRegistry::isOpaque(chunk.getBlock(x, y - 1, z)))
+					y--;
+				heights[x + z * SIZE] = y;
+			}
+		}
+
+		// sections below every column are dark as a whole, so only the sections around the surface get light of their own
+		int darkHeight = *std::ranges::min_element(heights) / SIZE * SIZE;
+		for (int sectionY = 0; sectionY < darkHeight / SIZE; sectionY++)
+			chunk.darken(sectionY);
+
+		for (int z = 0; z < SIZE; z++)
+			for (int x = 0; x < SIZE; x++)
+				for (int y = darkHeight; y < heights[x + z * SIZE]; y++)
+					chunk.setLight(LightType::SKY, x, y, z, 0);
+
+		Propagator sky(region, LightType::SKY);
+		for (int z = 0; z < SIZE; z++) {
+			for (int x = 0; x < SIZE; x++) {
+				// the sky can only reach sideways into the parts of neighbouring columns that are below their first opaque block
+				int highest = 0;
+				for (glm::ivec2 offset : { glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1) }) {
+					glm::ivec2 neighbour = glm::ivec2(x, z) + offset;
+					if (neighbour.x >= 0 && neighbour.y >= 0 && neighbour.x < SIZE && neighbour.y < SIZE)
+						highest = std::max(highest, heights[neighbour.x + neighbour.y * SIZE]);
+				}
+
+				for (int y = heights[x + z * SIZE]; y < highest; y++)
+					sky.add(region.toLocal({ chunk.getPosition().x * SIZE + x, y, chunk.getPosition().y * SIZE + z }));
+			}
+		}
+		sky.run();
+
+		Propagator block(region, LightType::BLOCK);
+		for (int sectionY = 0; sectionY < Chunk::SECTION_COUNT; sectionY++) {
+			const ChunkSection* section = chunk.getSection(sectionY);
+			if (!section || section->isEmpty())
+				continue;
+
+			for (int i = 0; i < ChunkSection::VOLUME; i++) {
+				if (uint8_t emitted = BlockRegistry::getLight(section->getBlock(i))) {
+					glm::ivec3 position = ChunkSection::position(i) + glm::ivec3(0, sectionY * SIZE, 0);
+					chunk.setLight(LightType::BLOCK, position.x, position.y, position.z, emitted);
+					block.add(region.toLocal(position + glm::ivec3(chunk.getPosition().x * SIZE, 0, chunk.getPosition().y * SIZE)));
+				}
+			}
+		}
+		block.run();
+
+		chunk.trimLight();
+	}
+
+	void Lighting::spreadBorders(LightRegion& region) {
+		if (!region.getChunk(region.getCenter()))
+			return;
+
+		for (LightType type : LIGHT_TYPES) {
+			Propagator propagator(region, type);
+
+			// pairs of blocks on both sides of each border of the center chunk, where one is more than a step brighter than the other
+			for (Face face : { Face::NEG_X, Face::POS_X, Face::NEG_Z, Face::POS_Z }) {
+				glm::ivec3 normal = faceNormal(face);
+				glm::ivec3 start(SIZE, 0, SIZE);
+				glm::ivec3 along(0);
+				if (faceAxis(face) == 0) {
+					start.x += faceSign(face) < 0 ? 0 : SIZE - 1;
+					along.z = 1;
+				} else {
+					start.z += faceSign(face) < 0 ? 0 : SIZE - 1;
+					along.x = 1;
+				}
+
+				if (!region.contains(start + normal))
+					continue;
+
+				for (int y = 0; y < Chunk::HEIGHT; y++) {
+					for (int i = 0; i < SIZE; i++) {
+						glm::ivec3 inside = start + along * i + glm::ivec3(0, y, 0);
+						glm::ivec3 outside = inside + normal;
+
+						uint8_t insideLevel = region.getLight(type, inside);
+						uint8_t outsideLevel = region.getLight(type, outside);
+						if (insideLevel > outsideLevel + 1)
+							propagator.add(inside);
+						else if (outsideLevel > insideLevel + 1)
+							propagator.add(outside);
+					}
+				}
+			}
+
+			propagator.run();
+		}
+	}
+
+	bool Lighting::setBlock(LightRegion& region, glm::ivec3 position, BlockId block) {
+		glm::ivec3 local = region.toLocal(position);
+		if (local.x < SIZE || local.z < SIZE || local.x >= 2 * SIZE || local.z >= 2 * SIZE || !region.contains(local))
+			return false;
+
+		if (region.getBlock(local) == block)
+			return false;
+
+		region.setBlock(local, block);
+
+		for (LightType type : LIGHT_TYPES) {
+			Propagator propagator(region, type);
+
+			// take away the light the block had, and everything that was lit through it
+			if (uint8_t level = region.getLight(type, local)) {
+				region.setLight(type, local, 0);
+				propagator.remove(local, level);
+			}
+
+			if (uint8_t emitted = type == LightType::BLOCK ? BlockRegistry::getLight(block) : 0) {
+				region.setLight(type, local, emitted);
+				propagator.add(local);
+			}
+
+			// light around a block that lets it through can spread into it again
+			if (!BlockRegistry::isOpaque(block)) {
+				for (int f = 0; f < FACE_COUNT; f++) {
+					glm::ivec3 neighbour = local + faceNormal(static_cast<Face>(f));
+					if (region.contains(neighbour))
+						propagator.add(neighbour);
+				}
+			}
+
+			propagator.run();
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,232 @@
+#include "mappedFile.h"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace Minecraft::IO {
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			close();
+
+#ifdef _WIN32
+			this->file = std::exchange(other.file, nullptr);
+			this->mapping = std::exchange(other.mapping, nullptr);
+#else
+			this->file = std::exchange(other.file, -1);
+#endif
+			this->isWritable = std::exchange(other.isWritable, false);
+			this->data = std::exchange(other.data, nullptr);
+			this->size = std::exchange(other.size, 0);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+		std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+		HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			std::cerr << "could not open '" << path << "'" << std::endl;
+			return nullptr;
+		}
+		file->file = handle;
+
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(handle, &fileSize);
+		size_t size = fileSize.QuadPart;
+#else
+		file->file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file->file < 0) {
+			std::cerr << "could not open '" << path << "'" << std::endl;
+			return nullptr;
+		}
+
+		struct stat info{};
+		fstat(file->file, &info);
+		size_t size = info.st_size;
+#endif
+
+		if (!file->map(size))
+			return nullptr;
+
+		return file;
+	}
+
+	std::shared_ptr<MappedFile> MappedFile::openWritable(const std::filesystem::path& path) {
+		std::shared_ptr<MappedFile> file(new MappedFile());
+		file->isWritable = true;
+
+		if (path.has_parent_path()) {
+			std::error_code error;
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+
+#ifdef _WIN32
+		HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			std::cerr << "could not open '" << path << "' for writing" << std::endl;
+			return nullptr;
+		}
+		file->file = handle;
+
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(handle, &fileSize);
+		size_t size = fileSize.QuadPart;
+#else
+		file->file = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (file->file < 0) {
+			std::cerr << "could not open '" << path << "' for writing" << std::endl;
+			return nullptr;
+		}
+
+		struct stat info{};
+		fstat(file->file, &info);
+		size_t size = info.st_size;
+#endif
+
+		if (!file->map(size))
+			return nullptr;
+
+		return file;
+	}
+
+	std::span<const uint8_t> MappedFile::getData() const {
+		return { data, size };
+	}
+
+	size_t MappedFile::getSize() const {
+		return size;
+	}
+
+	bool MappedFile::write(size_t offset, std::span<const uint8_t> bytes) {
+		if (!isWritable) {
+			std::cerr << "attempted to write to a read only file" << std::endl;
+			return false;
+		}
+
+#ifdef _WIN32
+		// a mapping can't grow, so it has to be recreated when the file does
+		size_t end = offset + bytes.size();
+		if (end > size)
+			unmap();
+
+		OVERLAPPED overlapped{};
+		overlapped.Offset = DWORD(offset);
+		overlapped.OffsetHigh = DWORD(uint64_t(offset) >> 32);
+		DWORD written = 0;
+		if (!WriteFile(file, bytes.data(), DWORD(bytes.size()), &written, &overlapped) || written != bytes.size()) {
+			std::cerr << "could not write " << bytes.size() << " bytes at " << offset << std::endl;
+			return false;
+		}
+
+		if (end > size)
+			return map(end);
+#else
+		size_t written = 0;
+		while (written < bytes.size()) {
+			ssize_t result = pwrite(file, bytes.data() + written, bytes.size() - written, offset + written);
+			if (result < 0) {
+				std::cerr << "could not write " << bytes.size() << " bytes at " << offset << std::endl;
+				return false;
+			}
+			written += result;
+		}
+
+		// the mapping is shared, so it already sees the written bytes as long as they're within its range
+		if (offset + bytes.size() > size) {
+			unmap();
+			return map(offset + bytes.size());
+		}
+#endif
+
+		return true;
+	}
+
+	bool MappedFile::sync() {
+#ifdef _WIN32
+		return FlushFileBuffers(file);
+#else
+		return fdatasync(file) == 0;
+#endif
+	}
+
+	bool MappedFile::map(size_t size) {
+		this->size = size;
+		this->data = nullptr;
+
+		// mapping an empty file isn't allowed
+		if (size == 0)
+			return true;
+
+#ifdef _WIN32
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			std::cerr << "could not create file mapping" << std::endl;
+			return false;
+		}
+
+		data = (const uint8_t*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+		data = address == MAP_FAILED ? nullptr : (const uint8_t*) address;
+#endif
+
+		if (!data) {
+			std::cerr << "could not map " << size << " bytes" << std::endl;
+			this->size = 0;
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::unmap() {
+#ifdef _WIN32
+		if (data)
+			UnmapViewOfFile(data);
+		if (mapping)
+			CloseHandle(mapping);
+		mapping = nullptr;
+#else
+		if (data)
+			munmap((void*) data, size);
+#endif
+
+		data = nullptr;
+		size = 0;
+	}
+
+	void MappedFile::close() {
+		unmap();
+
+#ifdef _WIN32
+		if (file)
+			CloseHandle(file);
+		file = nullptr;
+#else
+		if (file >= 0)
+			::close(file);
+		file = -1;
+#endif
+	}
+}
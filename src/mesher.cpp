@@ -0,0 +1,216 @@
+#include "mesher.h"
+
+namespace Minecraft::World {
+	namespace {
+		constexpr int SIZE = ChunkSection::SIZE;
+		/// section with a 1 block border taken from the neighbours
+		constexpr int PADDED = SIZE + 2;
+
+		constexpr int paddedIndex(int x, int y, int z) { return ((y + 1) * PADDED + (z + 1)) * PADDED + (x + 1); }
+		constexpr int paddedIndex(glm::ivec3 pos) { return paddedIndex(pos.x, pos.y, pos.z); }
+
+		/// ambient occlusion of a face corner, from the blocks touching the corner in the layer in front of the face
+		constexpr uint8_t ambientOcclusion(bool side1, bool side2, bool corner) {
+			if (side1 && side2)
+				return 0;
+			return 3 - (side1 + side2 + corner);
+		}
+
+		/// block light and sky light of a block in one byte, sections without light have the default light
+		uint8_t packLight(const SectionLight* light, int index) {
+			if (!light)
+				return SectionLight::defaultLevel(LightType::BLOCK) | SectionLight::defaultLevel(LightType::SKY) << 4;
+			return light->get(LightType::BLOCK, index) | light->get(LightType::SKY, index) << 4;
+		}
+	}
+
+	ChunkMesh Mesher::mesh(const ChunkSection& section, const Neighbours& neighbours, bool greedy, const MeshLight& light) {
+		ChunkMesh mesh{};
+		mesh.visibility = Visibility::compute(section);
+
+		if (section.isEmpty())
+			return mesh;
+
+		// decode the palette once, the face loops below look at every block up to 7 times
+		std::vector<BlockId> blocks(PADDED * PADDED * PADDED, AIR);
+		for (int y = 0; y < SIZE; y++)
+			for (int z = 0; z < SIZE; z++)
+				for (int x = 0; x < SIZE; x++)
+					blocks[paddedIndex(x, y, z)] = section.getBlock(x, y, z);
+
+		for (int f = 0; f < FACE_COUNT; f++) {
+			const ChunkSection* neighbour = neighbours[f];
+			if (!neighbour || neighbour->isEmpty())
+				continue;
+
+			Face face = static_cast<Face>(f);
+			int a = faceAxis(face);
+			int b = (a + 1) % 3;
+			int c = (a + 2) % 3;
+
+			glm::ivec3 pos(0);
+			glm::ivec3 other(0);
+			pos[a] = faceSign(face) < 0 ? -1 : SIZE;
+			other[a] = faceSign(face) < 0 ? SIZE - 1 : 0;
+			for (int j = 0; j < SIZE; j++) {
+				for (int i = 0; i < SIZE; i++) {
+					pos[b] = other[b] = i;
+					pos[c] = other[c] = j;
+					blocks[paddedIndex(pos)] = neighbour->getBlock(other);
+				}
+			}
+		}
+
+		// block light in the low and sky light in the high 4 bits, faces are lit by the block in front of them
+		std::vector<uint8_t> levels(PADDED * PADDED * PADDED, packLight(nullptr, 0));
+		for (int y = 0; y < SIZE; y++)
+			for (int z = 0; z < SIZE; z++)
+				for (int x = 0; x < SIZE; x++)
+					levels[paddedIndex(x, y, z)] = packLight(light.section, ChunkSection::index(x, y, z));
+
+		for (int f = 0; f < FACE_COUNT; f++) {
+			Face face = static_cast<Face>(f);
+			int a = faceAxis(face);
+			int b = (a + 1) % 3;
+			int c = (a + 2) % 3;
+
+			glm::ivec3 pos(0);
+			glm::ivec3 other(0);
+			pos[a] = faceSign(face) < 0 ? -1 : SIZE;
+			other[a] = faceSign(face) < 0 ? SIZE - 1 : 0;
+			for (int j = 0; j < SIZE; j++) {
+				for (int i = 0; i < SIZE; i++) {
+					pos[b] = other[b] = i;
+					pos[c] = other[c] = j;
+					levels[paddedIndex(pos)] = packLight(light.neighbours[f], ChunkSection::index(other.x, other.y, other.z));
+				}
+			}
+		}
+
+		std::vector<bool> opaque(blocks.size(), false);
+		for (size_t i = 0; i < blocks.size(); i++)
+			opaque[i] = BlockRegistry::isOpaque(blocks[i]);
+
+		// visible faces per cell of a slice, faces with the same key can be merged
+		// bit 32 marks the face as visible, followed by the light, the ambient occlusion of each corner and the texture index
+		std::array<uint64_t, SIZE * SIZE> mask;
+
+		for (int f = 0; f < FACE_COUNT; f++) {
+			Face face = static_cast<Face>(f);
+			int a = faceAxis(face);
+			int b = (a + 1) % 3;
+			int c = (a + 2) % 3;
+			int sign = faceSign(face);
+			int neighbourOffset = paddedIndex(faceNormal(face)) - paddedIndex(0, 0, 0);
+
+			glm::ivec3 bStep(0);
+			bStep[b] = 1;
+			glm::ivec3 cStep(0);
+			cStep[c] = 1;
+			int bOffset = paddedIndex(bStep) - paddedIndex(0, 0, 0);
+			int cOffset = paddedIndex(cStep) - paddedIndex(0, 0, 0);
+
+			for (int layer = 0; layer < SIZE; layer++) {
+				glm::ivec3 pos(0);
+				pos[a] = layer;
+
+				for (int j = 0; j < SIZE; j++) {
+					pos[c] = j;
+					for (int i = 0; i < SIZE; i++) {
+						pos[b] = i;
+
+						int index = paddedIndex(pos);
+						BlockId block = blocks[index];
+						BlockId neighbour = blocks[index + neighbourOffset];
+
+						if (block == AIR || block == neighbour || opaque[index + neighbourOffset]) {
+							mask[j * SIZE + i] = 0;
+							continue;
+						}
+
+						// corners in the order they are emitted in, -b -c, +b -c, +b +c, -b +c
+						int front = index + neighbourOffset;
+						bool sides[] = { opaque[front - bOffset], opaque[front - cOffset], opaque[front + bOffset], opaque[front + cOffset] };
+						uint32_t ao =
+							ambientOcclusion(sides[0], sides[1], opaque[front - bOffset - cOffset]) |
+							ambientOcclusion(sides[2], sides[1], opaque[front + bOffset - cOffset]) << 2 |
+							ambientOcclusion(sides[2], sides[3], opaque[front + bOffset + cOffset]) << 4 |
+							ambientOcclusion(sides[0], sides[3], opaque[front - bOffset + cOffset]) << 6;
+
+						mask[j * SIZE + i] = uint64_t(1) << 32 | uint64_t(levels[front]) << 24 | ao << 16 | BlockRegistry::get(block).textures[f];
+					}
+				}
+
+				for (int j = 0; j < SIZE; j++) {
+					for (int i = 0; i < SIZE;) {
+						uint64_t key = mask[j * SIZE + i];
+						if (key == 0) {
+							i++;
+							continue;
+						}
+
+						int width = 1;
+						int height = 1;
+						if (greedy) {
+							while (i + width < SIZE && mask[j * SIZE + i + width] == key)
+								width++;
+
+							for (bool canGrow = true; canGrow && j + height < SIZE; ) {
+								for (int k = 0; k < width; k++) {
+									if (mask[(j + height) * SIZE + i + k] != key) {
+										canGrow = false;
+										break;
+									}
+								}
+								if (canGrow)
+									height++;
+							}
+						}
+
+						for (int v = 0; v < height; v++)
+							for (int u = 0; u < width; u++)
+								mask[(j + v) * SIZE + i + u] = 0;
+
+						glm::ivec3 corner(0);
+						corner[a] = layer + (sign > 0 ? 1 : 0);
+						corner[b] = i;
+						corner[c] = j;
+						glm::ivec3 du(0);
+						du[b] = width;
+						glm::ivec3 dv(0);
+						dv[c] = height;
+
+						glm::ivec3 corners[] = { corner, corner + du, corner + du + dv, corner + dv };
+						uint8_t ao[] = { uint8_t(key >> 16 & 0x3), uint8_t(key >> 18 & 0x3), uint8_t(key >> 20 & 0x3), uint8_t(key >> 22 & 0x3) };
+						uint16_t texture = key & 0xFFFF;
+						uint8_t level = key >> 24 & 0xFF;
+
+						uint32_t base = mesh.vertices.size();
+						for (int k = 0; k < 4; k++)
+							mesh.vertices.push_back(ChunkVertex::pack(corners[k], face, ao[k], texture, level & 0xF, level >> 4));
+
+						// counter clockwise when looking at the face from the direction of its normal,
+						// split along the darkest diagonal so the occlusion is interpolated across both triangles
+						bool flip = ao[0] + ao[2] > ao[1] + ao[3];
+						if (sign > 0) {
+							if (flip)
+								mesh.indices.insert(mesh.indices.end(), { base + 1, base + 2, base + 3, base + 3, base, base + 1 });
+							else
+								mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+						} else {
+							if (flip)
+								mesh.indices.insert(mesh.indices.end(), { base + 1, base, base + 3, base + 3, base + 2, base + 1 });
+							else
+								mesh.indices.insert(mesh.indices.end(), { base, base + 3, base + 2, base + 2, base + 1, base });
+						}
+						mesh.faceCount += width * height;
+
+						i += width;
+					}
+				}
+			}
+		}
+
+		return mesh;
+	}
+}
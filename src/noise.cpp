@@ -0,0 +1,200 @@
+#include "noise.h"
+
+#include <numeric>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MINECRAFT_NOISE_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace Minecraft::World {
+	namespace {
+		/// splitmix64, used instead of <random> so the permutation doesn't depend on the standard library implementation
+		uint64_t nextRandom(uint64_t& state) {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		int fastFloor(float x) {
+			int i = (int) x;
+			return x < i ? i - 1 : i;
+		}
+
+		float fade(float t) {
+			return t * t * t * (t * (t * 6 - 15) + 10);
+		}
+
+		float lerp(float t, float a, float b) {
+			return a + t * (b - a);
+		}
+
+		float grad(int hash, float x, float y, float z) {
+			int h = hash & 15;
+			float u = h < 8 ? x : y;
+			float v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+			return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+		}
+
+#ifdef MINECRAFT_NOISE_SSE2
+		__m128 select(__m128 mask, __m128 a, __m128 b) {
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		__m128 lerp(__m128 t, __m128 a, __m128 b) {
+			return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+		}
+
+		__m128 fade(__m128 t) {
+			__m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6)), _mm_set1_ps(15))), _mm_set1_ps(10));
+			return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+		}
+
+		__m128 grad(__m128i hash, __m128 x, __m128 y, __m128 z) {
+			__m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+
+			__m128 hLess8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+			__m128 hLess4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+			__m128 h12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)), _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+
+			__m128 u = select(hLess8, x, y);
+			__m128 v = select(hLess4, y, select(h12or14, x, z));
+
+			// bit 0 and 1 of the hash flip the sign of u and v
+			__m128 signU = _mm_castsi128_ps(_mm_slli_epi32(h, 31));
+			__m128 signV = _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(h, 30), _mm_set1_epi32(INT32_MIN)));
+
+			return _mm_add_ps(_mm_xor_ps(u, signU), _mm_xor_ps(v, signV));
+		}
+
+		/// floor for floats within int range, as SSE2 has no rounding instruction
+		__m128i floorToInt(__m128 x) {
+			__m128i truncated = _mm_cvttps_epi32(x);
+			// the compare mask is -1 where truncating rounded up, which is exactly the correction needed
+			return _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x)));
+		}
+#endif
+	}
+
+	Noise::Noise(uint32_t seed) {
+		std::array<int32_t, 256> values;
+		std::iota(values.begin(), values.end(), 0);
+
+		uint64_t state = seed;
+		for (size_t i = values.size() - 1; i > 0; i--)
+			std::swap(values[i], values[nextRandom(state) % (i + 1)]);
+
+		for (size_t i = 0; i < permutation.size(); i++)
+			permutation[i] = values[i & 255];
+	}
+
+	float Noise::sample(float x, float y, float z) const {
+		int X = fastFloor(x);
+		int Y = fastFloor(y);
+		int Z = fastFloor(z);
+
+		x -= X;
+		y -= Y;
+		z -= Z;
+
+		X &= 255;
+		Y &= 255;
+		Z &= 255;
+
+		float u = fade(x);
+		float v = fade(y);
+		float w = fade(z);
+
+		const int32_t* p = permutation.data();
+		int A = p[X] + Y;
+		int AA = p[A] + Z;
+		int AB = p[A + 1] + Z;
+		int B = p[X + 1] + Y;
+		int BA = p[B] + Z;
+		int BB = p[B + 1] + Z;
+
+		return lerp(w,
+			lerp(v,
+				lerp(u, grad(p[AA], x, y, z), grad(p[BA], x - 1, y, z)),
+				lerp(u, grad(p[AB], x, y - 1, z), grad(p[BB], x - 1, y - 1, z))),
+			lerp(v,
+				lerp(u, grad(p[AA + 1], x, y, z - 1), grad(p[BA + 1], x - 1, y, z - 1)),
+				lerp(u, grad(p[AB + 1], x, y - 1, z - 1), grad(p[BB + 1], x - 1, y - 1, z - 1))));
+	}
+
+	void Noise::sample(const float* x, const float* y, const float* z, float* out, size_t count) const {
+		size_t i = 0;
+
+#ifdef MINECRAFT_NOISE_SSE2
+		const int32_t* p = permutation.data();
+		const __m128 one = _mm_set1_ps(1);
+		const __m128i mask = _mm_set1_epi32(255);
+
+		for (; i + 4 <= count; i += 4) {
+			__m128 px = _mm_loadu_ps(x + i);
+			__m128 py = _mm_loadu_ps(y + i);
+			__m128 pz = _mm_loadu_ps(z + i);
+
+			__m128i ix = floorToInt(px);
+			__m128i iy = floorToInt(py);
+			__m128i iz = floorToInt(pz);
+
+			px = _mm_sub_ps(px, _mm_cvtepi32_ps(ix));
+			py = _mm_sub_ps(py, _mm_cvtepi32_ps(iy));
+			pz = _mm_sub_ps(pz, _mm_cvtepi32_ps(iz));
+
+			alignas(16) int32_t X[4];
+			alignas(16) int32_t Y[4];
+			alignas(16) int32_t Z[4];
+			_mm_store_si128((__m128i*) X, _mm_and_si128(ix, mask));
+			_mm_store_si128((__m128i*) Y, _mm_and_si128(iy, mask));
+			_mm_store_si128((__m128i*) Z, _mm_and_si128(iz, mask));
+
+			// SSE2 has no gather, so the table lookups are done per lane
+			alignas(16) int32_t hashes[8][4];
+			for (int lane = 0; lane < 4; lane++) {
+				int A = p[X[lane]] + Y[lane];
+				int AA = p[A] + Z[lane];
+				int AB = p[A + 1] + Z[lane];
+				int B = p[X[lane] + 1] + Y[lane];
+				int BA = p[B] + Z[lane];
+				int BB = p[B + 1] + Z[lane];
+
+				hashes[0][lane] = p[AA];
+				hashes[1][lane] = p[BA];
+				hashes[2][lane] = p[AB];
+				hashes[3][lane] = p[BB];
+				hashes[4][lane] = p[AA + 1];
+				hashes[5][lane] = p[BA + 1];
+				hashes[6][lane] = p[AB + 1];
+				hashes[7][lane] = p[BB + 1];
+			}
+
+			__m128 u = fade(px);
+			__m128 v = fade(py);
+			__m128 w = fade(pz);
+
+			__m128 x1 = _mm_sub_ps(px, one);
+			__m128 y1 = _mm_sub_ps(py, one);
+			__m128 z1 = _mm_sub_ps(pz, one);
+
+			auto hash = [&hashes](int corner) { return _mm_load_si128((const __m128i*) hashes[corner]); };
+
+			__m128 result = lerp(w,
+				lerp(v,
+					lerp(u, grad(hash(0), px, py, pz), grad(hash(1), x1, py, pz)),
+					lerp(u, grad(hash(2), px, y1, pz), grad(hash(3), x1, y1, pz))),
+				lerp(v,
+					lerp(u, grad(hash(4), px, py, z1), grad(hash(5), x1, py, z1)),
+					lerp(u, grad(hash(6), px, y1, z1), grad(hash(7), x1, y1, z1))));
+
+			_mm_storeu_ps(out + i, result);
+		}
+#endif
+
+		for (; i < count; i++)
+			out[i] = sample(x[i], y[i], z[i]);
+	}
+}
@@ -0,0 +1,193 @@
+#include "profiler.h"
+#include "traceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+
+namespace Minecraft::Profiling {
+	Profiler& Profiler::get() {
+		static Profiler profiler;
+		return profiler;
+	}
+
+	int64_t Profiler::now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Profiler::setEnabled(bool enabled) {
+		this->enabled = enabled;
+	}
+
+	bool Profiler::isEnabled() const {
+		return enabled;
+	}
+
+	void Profiler::setThreadName(const std::string& name) {
+		ThreadBuffer& buffer = getThreadBuffer();
+
+		std::lock_guard lock(threadsMutex);
+		buffer.name = name;
+	}
+
+	std::vector<std::string> Profiler::getThreadNames() const {
+		std::lock_guard lock(threadsMutex);
+
+		std::vector<std::string> names;
+		for (const std::shared_ptr<ThreadBuffer>& thread : threads)
+			names.push_back(thread->name);
+		return names;
+	}
+
+	void Profiler::beginFrame() {
+		frameStart = now();
+
+		if (!enabled && !TraceRecorder::get().isRecording())
+			return;
+
+		// the clocks drift apart, so they are lined up again every second
+		if (frameStart - lastGpuSync > 1'000'000'000) {
+			GLint64 gpuTime = 0;
+			glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+			gpuOffset = now() - gpuTime;
+			lastGpuSync = frameStart;
+		}
+	}
+
+	void Profiler::endFrame() {
+		FrameProfile frame;
+		frame.index = frameIndex++;
+		frame.start = frameStart;
+		frame.end = now();
+
+		{
+			std::lock_guard lock(threadsMutex);
+			for (const std::shared_ptr<ThreadBuffer>& thread : threads) {
+				std::lock_guard threadLock(thread->mutex);
+				frame.cpuZones.insert(frame.cpuZones.end(), thread->zones.begin(), thread->zones.end());
+				thread->zones.clear();
+			}
+		}
+		std::ranges::sort(frame.cpuZones, {}, &Zone::start);
+
+		TraceRecorder::get().recordZone("frame", frame.start, frame.end, TraceRecorder::FRAME_TRACK);
+
+		frames.push_back(std::move(frame));
+		while (frames.size() > HISTORY_SIZE)
+			frames.pop_front();
+
+		readGpuZones();
+	}
+
+	const std::deque<FrameProfile>& Profiler::getFrames() const {
+		return frames;
+	}
+
+	Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+		// the profiler keeps the buffer alive after the thread exits, so the zones of its last frame aren't lost
+		thread_local std::shared_ptr<ThreadBuffer> threadBuffer = nullptr;
+		if (!threadBuffer) {
+			std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+
+			std::lock_guard lock(threadsMutex);
+			buffer->index = threads.size();
+			buffer->name = std::format("thread {}", buffer->index);
+			threads.push_back(buffer);
+			threadBuffer = buffer;
+		}
+
+		return *threadBuffer;
+	}
+
+	GLuint Profiler::acquireQuery() {
+		if (freeQueries.empty()) {
+			freeQueries.resize(64);
+			glGenQueries(freeQueries.size(), freeQueries.data());
+		}
+
+		GLuint query = freeQueries.back();
+		freeQueries.pop_back();
+		return query;
+	}
+
+	void Profiler::readGpuZones() {
+		while (!pendingGpuZones.empty()) {
+			PendingGpuZone& pending = pendingGpuZones.front();
+			// still open, or part of the frame that is about to start
+			if (pending.endQuery == 0)
+				break;
+
+			// queries finish in order, so the start is available when the end is
+			GLint isAvailable = GL_FALSE;
+			glGetQueryObjectiv(pending.endQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+			if (isAvailable == GL_FALSE)
+				break;
+
+			GLint64 start = 0;
+			GLint64 end = 0;
+			glGetQueryObjecti64v(pending.startQuery, GL_QUERY_RESULT, &start);
+			glGetQueryObjecti64v(pending.endQuery, GL_QUERY_RESULT, &end);
+			freeQueries.push_back(pending.startQuery);
+			freeQueries.push_back(pending.endQuery);
+
+			auto frame = std::ranges::find(frames, pending.frame, &FrameProfile::index);
+			if (frame != frames.end())
+				frame->gpuZones.push_back({ pending.name, start + gpuOffset, end + gpuOffset, pending.depth, 0 });
+			TraceRecorder::get().recordZone(pending.name, start + gpuOffset, end + gpuOffset, TraceRecorder::GPU_TRACK);
+
+			pendingGpuZones.pop_front();
+		}
+
+		// every frame before the oldest zone that is still pending has all its gpu zones
+		uint64_t completeBefore = pendingGpuZones.empty() ? frameIndex : pendingGpuZones.front().frame;
+		for (FrameProfile& frame : frames)
+			if (frame.index < completeBefore)
+				frame.isGpuComplete = true;
+	}
+
+	CpuZone::CpuZone(const char* name) : name(name) {
+		Profiler& profiler = Profiler::get();
+		if (!profiler.enabled.load(std::memory_order_relaxed) && !TraceRecorder::get().isRecording())
+			return;
+
+		buffer = &profiler.getThreadBuffer();
+		buffer->depth++;
+		start = Profiler::now();
+	}
+
+	CpuZone::~CpuZone() {
+		if (!buffer)
+			return;
+
+		int64_t end = Profiler::now();
+		buffer->depth--;
+
+		TraceRecorder::get().recordZone(name, start, end, buffer->index);
+
+		if (Profiler::get().isEnabled()) {
+			std::lock_guard lock(buffer->mutex);
+			buffer->zones.push_back({ name, start, end, buffer->depth, buffer->index });
+		}
+	}
+
+	GpuZone::GpuZone(const char* name) {
+		Profiler& profiler = Profiler::get();
+		if (!profiler.enabled.load(std::memory_order_relaxed) && !TraceRecorder::get().isRecording())
+			return;
+
+		zone = &profiler.pendingGpuZones.emplace_back(Profiler::PendingGpuZone{ name, profiler.gpuDepth++, profiler.frameIndex, profiler.acquireQuery(), 0 });
+		glQueryCounter(zone->startQuery, GL_TIMESTAMP);
+	}
+
+	GpuZone::~GpuZone() {
+		if (!zone)
+			return;
+
+		Profiler& profiler = Profiler::get();
+		profiler.gpuDepth--;
+
+		GLuint query = profiler.acquireQuery();
+		glQueryCounter(query, GL_TIMESTAMP);
+		zone->endQuery = query;
+	}
+}
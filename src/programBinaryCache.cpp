@@ -0,0 +1,77 @@
+#include "programBinaryCache.h"
+#include "binary.h"
+#include "cacheEntry.h"
+
+#include <format>
+#include <vector>
+
+namespace Minecraft::Assets {
+	namespace {
+		constexpr std::string_view MAGIC = "MCPB";
+		constexpr uint8_t VERSION = 2;
+		/// binary format
+		constexpr size_t METADATA_SIZE = 4;
+
+		std::string getString(GLenum name) {
+			const GLubyte* string = glGetString(name);
+			return string ? (const char*) string : "";
+		}
+	}
+
+	ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory) : directory(std::move(directory)) {
+		GLint formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		supported = formatCount > 0;
+
+		driver = std::format("{}\n{}\n{}\n", getString(GL_VENDOR), getString(GL_RENDERER), getString(GL_VERSION));
+	}
+
+	bool ProgramBinaryCache::isSupported() const {
+		return supported;
+	}
+
+	bool ProgramBinaryCache::load(GLuint program, const std::string& _key) {
+		if (!supported)
+			return false;
+
+		std::string key = driver + _key;
+		std::shared_ptr<IO::CacheEntry> entry = IO::CacheEntry::read(getEntryPath(key), MAGIC, VERSION, key);
+		if (!entry || entry->getMetadata().size() != METADATA_SIZE)
+			return false;
+
+		GLenum format = IO::readLittleEndian<uint32_t>(entry->getMetadata(), 0);
+		std::span<const uint8_t> binary = entry->getPayload();
+		glProgramBinary(program, format, binary.data(), binary.size());
+
+		// a driver update can reject binaries of the version before it, even when the version string didn't change
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		return isLinked == GL_TRUE;
+	}
+
+	void ProgramBinaryCache::store(GLuint program, const std::string& _key) {
+		if (!supported)
+			return;
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		std::vector<uint8_t> binary(length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+		binary.resize(length);
+
+		std::vector<uint8_t> metadata;
+		metadata.reserve(METADATA_SIZE);
+		IO::writeLittleEndian<uint32_t>(metadata, format);
+
+		std::string key = driver + _key;
+		IO::CacheEntry::write(getEntryPath(key), MAGIC, VERSION, key, metadata, binary);
+	}
+
+	std::filesystem::path ProgramBinaryCache::getEntryPath(const std::string& key) const {
+		return IO::CacheEntry::getPath(directory, key, "bin");
+	}
+}
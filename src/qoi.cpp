@@ -0,0 +1,191 @@
+#include "qoi.h"
+
+#include <array>
+#include <cstring>
+#include <iostream>
+
+namespace Minecraft::Assets {
+	namespace {
+		constexpr uint8_t OP_INDEX = 0x00;
+		constexpr uint8_t OP_DIFF = 0x40;
+		constexpr uint8_t OP_LUMA = 0x80;
+		constexpr uint8_t OP_RUN = 0xC0;
+		constexpr uint8_t OP_RGB = 0xFE;
+		constexpr uint8_t OP_RGBA = 0xFF;
+		constexpr uint8_t TAG_MASK = 0xC0;
+
+		constexpr size_t HEADER_SIZE = 14;
+		constexpr std::array<uint8_t, 8> END_MARKER = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		/// same limit as the reference implementation, so the size can't overflow
+		constexpr uint64_t MAX_PIXELS = 400'000'000;
+
+		struct Pixel {
+			uint8_t r = 0;
+			uint8_t g = 0;
+			uint8_t b = 0;
+			uint8_t a = 0;
+
+			bool operator==(const Pixel&) const = default;
+		};
+
+		uint8_t hash(Pixel pixel) {
+			return (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+		}
+
+		uint32_t readBigEndian(const uint8_t* data) {
+			return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 | uint32_t(data[2]) << 8 | data[3];
+		}
+
+		void writeBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+			for (int shift = 24; shift >= 0; shift -= 8)
+				out.push_back(uint8_t(value >> shift));
+		}
+	}
+
+	bool Qoi::isQoi(std::span<const uint8_t> data) {
+		return data.size() >= 4 && std::memcmp(data.data(), "qoif", 4) == 0;
+	}
+
+	std::shared_ptr<Image> Qoi::decode(std::span<const uint8_t> data) {
+		if (!isQoi(data) || data.size() < HEADER_SIZE + END_MARKER.size()) {
+			std::cerr << "qoi data is too small or has the wrong magic bytes" << std::endl;
+			return nullptr;
+		}
+
+		uint32_t width = readBigEndian(&data[4]);
+		uint32_t height = readBigEndian(&data[8]);
+		uint8_t channels = data[12];
+		if (width == 0 || height == 0 || uint64_t(width) * height > MAX_PIXELS || (channels != 3 && channels != 4)) {
+			std::cerr << "qoi header is invalid" << std::endl;
+			return nullptr;
+		}
+
+		std::shared_ptr<Image> image = std::make_shared<Image>(glm::ivec2(width, height));
+		uint8_t* out = image->getData();
+		uint8_t* outEnd = out + image->getByteSize();
+
+		const uint8_t* in = data.data() + HEADER_SIZE;
+		// every op is at most 5 bytes, so checking against the start of the end marker keeps reads in bounds
+		const uint8_t* inEnd = data.data() + data.size() - END_MARKER.size();
+
+		std::array<Pixel, 64> index = {};
+		Pixel pixel = { 0, 0, 0, 255 };
+
+		while (out < outEnd) {
+			if (in >= inEnd) {
+				std::cerr << "qoi data ends before the image is complete" << std::endl;
+				return nullptr;
+			}
+
+			uint8_t op = *in++;
+			size_t run = 1;
+
+			if (op == OP_RGB) {
+				pixel.r = in[0];
+				pixel.g = in[1];
+				pixel.b = in[2];
+				in += 3;
+			} else if (op == OP_RGBA) {
+				pixel = { in[0], in[1], in[2], in[3] };
+				in += 4;
+			} else if ((op & TAG_MASK) == OP_INDEX) {
+				pixel = index[op];
+			} else if ((op & TAG_MASK) == OP_DIFF) {
+				pixel.r += ((op >> 4) & 0x03) - 2;
+				pixel.g += ((op >> 2) & 0x03) - 2;
+				pixel.b += (op & 0x03) - 2;
+			} else if ((op & TAG_MASK) == OP_LUMA) {
+				int greenDiff = (op & 0x3F) - 32;
+				uint8_t next = *in++;
+				pixel.r += greenDiff - 8 + ((next >> 4) & 0x0F);
+				pixel.g += greenDiff;
+				pixel.b += greenDiff - 8 + (next & 0x0F);
+			} else {
+				run = (op & 0x3F) + 1;
+				if (run > size_t(outEnd - out) / 4) {
+					std::cerr << "qoi run goes past the end of the image" << std::endl;
+					return nullptr;
+				}
+			}
+
+			index[hash(pixel)] = pixel;
+			for (size_t i = 0; i < run; i++) {
+				std::memcpy(out, &pixel, 4);
+				out += 4;
+			}
+		}
+
+		return image;
+	}
+
+	std::vector<uint8_t> Qoi::encode(const Image& image) {
+		glm::ivec2 size = image.getSize();
+
+		std::vector<uint8_t> out;
+		// a rough guess, most images compress well below their raw size
+		out.reserve(HEADER_SIZE + image.getByteSize() / 2 + END_MARKER.size());
+
+		out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+		writeBigEndian(out, size.x);
+		writeBigEndian(out, size.y);
+		out.push_back(4);
+		// sRGB with linear alpha
+		out.push_back(0);
+
+		std::array<Pixel, 64> index = {};
+		Pixel previous = { 0, 0, 0, 255 };
+		uint8_t run = 0;
+
+		const uint8_t* in = image.getData();
+		size_t pixelCount = image.getByteSize() / 4;
+		for (size_t i = 0; i < pixelCount; i++) {
+			Pixel pixel = { in[i * 4], in[i * 4 + 1], in[i * 4 + 2], in[i * 4 + 3] };
+
+			if (pixel == previous) {
+				run++;
+				// 63 and 64 would collide with OP_RGB and OP_RGBA
+				if (run == 62 || i == pixelCount - 1) {
+					out.push_back(OP_RUN | (run - 1));
+					run = 0;
+				}
+				continue;
+			}
+
+			if (run > 0) {
+				out.push_back(OP_RUN | (run - 1));
+				run = 0;
+			}
+
+			uint8_t position = hash(pixel);
+			if (index[position] == pixel) {
+				out.push_back(OP_INDEX | position);
+			} else {
+				index[position] = pixel;
+
+				if (pixel.a == previous.a) {
+					int8_t r = int8_t(pixel.r - previous.r);
+					int8_t g = int8_t(pixel.g - previous.g);
+					int8_t b = int8_t(pixel.b - previous.b);
+					int8_t rg = r - g;
+					int8_t bg = b - g;
+
+					if (r >= -2 && r <= 1 && g >= -2 && g <= 1 && b >= -2 && b <= 1) {
+						out.push_back(OP_DIFF | (r + 2) << 4 | (g + 2) << 2 | (b + 2));
+					} else if (rg >= -8 && rg <= 7 && g >= -32 && g <= 31 && bg >= -8 && bg <= 7) {
+						out.push_back(OP_LUMA | (g + 32));
+						out.push_back((rg + 8) << 4 | (bg + 8));
+					} else {
+						out.insert(out.end(), { OP_RGB, pixel.r, pixel.g, pixel.b });
+					}
+				} else {
+					out.insert(out.end(), { OP_RGBA, pixel.r, pixel.g, pixel.b, pixel.a });
+				}
+			}
+
+			previous = pixel;
+		}
+
+		out.insert(out.end(), END_MARKER.begin(), END_MARKER.end());
+		return out;
+	}
+}
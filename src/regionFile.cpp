@@ -0,0 +1,276 @@
+#include "regionFile.h"
+#include "binary.h"
+#include "compression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <utility>
+
+namespace Minecraft::World {
+	namespace {
+		/// the location table and the timestamp table
+		constexpr uint32_t HEADER_SECTORS = 2;
+		constexpr uint32_t MAX_CHUNK_SECTORS = 255;
+
+		/// compressed length, compression, uncompressed length and checksum of the compressed data
+		constexpr size_t CHUNK_HEADER_SIZE = 13;
+
+		enum class CompressionType : uint8_t {
+			NONE = 0,
+			LZ4 = 1,
+		};
+
+		constexpr uint32_t sectorOffset(uint32_t location) { return location >> 8; }
+		constexpr uint32_t sectorCount(uint32_t location) { return location & 0xFF; }
+	}
+
+	std::shared_ptr<RegionFile> RegionFile::open(const std::filesystem::path& path) {
+		std::shared_ptr<RegionFile> region(new RegionFile());
+
+		region->file = IO::MappedFile::openWritable(path);
+		if (!region->file)
+			return nullptr;
+
+		size_t size = region->file->getSize();
+		if (size == 0) {
+			std::vector<uint8_t> header(HEADER_SECTORS * SECTOR_SIZE, 0);
+			if (!region->file->write(0, header) || !region->file->sync())
+				return nullptr;
+			size = region->file->getSize();
+		}
+
+		if (size < HEADER_SECTORS * SECTOR_SIZE) {
+			std::cerr << "'" << path << "' is not a region file" << std::endl;
+			return nullptr;
+		}
+
+		size_t fileSectors = (size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+		region->usedSectors.assign(fileSectors, false);
+		for (uint32_t i = 0; i < HEADER_SECTORS; i++)
+			region->usedSectors[i] = true;
+
+		std::span<const uint8_t> data = region->file->getData();
+		for (int i = 0; i < CHUNK_COUNT; i++) {
+			uint32_t location = IO::readLittleEndian<uint32_t>(data, i * 4);
+			region->timestamps[i] = IO::readLittleEndian<uint32_t>(data, SECTOR_SIZE + i * 4);
+
+			uint32_t offset = sectorOffset(location);
+			uint32_t count = sectorCount(location);
+			if (location == 0)
+				continue;
+
+			// an entry pointing outside of the file can't be read, treat the chunk as missing
+			if (offset < HEADER_SECTORS || count == 0 || offset + count > fileSectors) {
+				std::cerr << "'" << path << "' has an invalid location for chunk " << i << std::endl;
+				continue;
+			}
+
+			region->locations[i] = location;
+			for (uint32_t sector = offset; sector < offset + count; sector++)
+				region->usedSectors[sector] = true;
+		}
+
+		return region;
+	}
+
+	bool RegionFile::hasChunk(glm::ivec2 position) const {
+		std::shared_lock lock(mutex);
+		return locations[index(position)] != 0;
+	}
+
+	std::shared_ptr<Chunk> RegionFile::read(glm::ivec2 position) const {
+		std::shared_lock lock(mutex);
+
+		uint32_t location = locations[index(position)];
+		if (location == 0)
+			return nullptr;
+
+		std::span<const uint8_t> data = file->getData().subspan(sectorOffset(location) * SECTOR_SIZE, sectorCount(location) * SECTOR_SIZE);
+
+		uint32_t length = IO::readLittleEndian<uint32_t>(data, 0);
+		CompressionType compression = static_cast<CompressionType>(data[4]);
+		uint32_t uncompressedLength = IO::readLittleEndian<uint32_t>(data, 5);
+		uint32_t checksum = IO::readLittleEndian<uint32_t>(data, 9);
+
+		if (length > data.size() - CHUNK_HEADER_SIZE) {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] is larger than its sectors" << std::endl;
+			return nullptr;
+		}
+
+		std::span<const uint8_t> payload = data.subspan(CHUNK_HEADER_SIZE, length);
+		if (IO::checksum(payload) != checksum) {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] failed its checksum" << std::endl;
+			return nullptr;
+		}
+
+		// the checksum only covers the payload, so the header fields are checked before they size anything
+		if (compression != CompressionType::NONE && compression != CompressionType::LZ4) {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] uses unknown compression " << int(compression) << std::endl;
+			return nullptr;
+		}
+		if (uncompressedLength > Chunk::MAX_SERIALIZED_SIZE) {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] has an invalid uncompressed length of " << uncompressedLength << std::endl;
+			return nullptr;
+		}
+
+		switch (compression) {
+			case CompressionType::NONE:
+				return Chunk::deserialize(position, payload);
+			case CompressionType::LZ4: {
+				std::vector<uint8_t> uncompressed(uncompressedLength);
+				if (!IO::Compression::decompress(payload, uncompressed)) {
+					std::cerr << "chunk [" << position.x << ", " << position.y << "] could not be decompressed" << std::endl;
+					return nullptr;
+				}
+				return Chunk::deserialize(position, uncompressed);
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool RegionFile::write(const Chunk& chunk) {
+		std::vector<uint8_t> uncompressed = chunk.serialize();
+		std::vector<uint8_t> compressed = IO::Compression::compress(uncompressed);
+
+		std::vector<uint8_t> data;
+		data.reserve(CHUNK_HEADER_SIZE + compressed.size());
+		IO::writeLittleEndian(data, uint32_t(compressed.size()));
+		IO::writeLittleEndian(data, uint8_t(CompressionType::LZ4));
+		IO::writeLittleEndian(data, uint32_t(uncompressed.size()));
+		IO::writeLittleEndian(data, IO::checksum(compressed));
+		data.insert(data.end(), compressed.begin(), compressed.end());
+		// whole sectors, so the file always ends on a sector boundary
+		data.resize((data.size() + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE, 0);
+
+		uint32_t count = data.size() / SECTOR_SIZE;
+		glm::ivec2 position = chunk.getPosition();
+		if (count > MAX_CHUNK_SECTORS) {
+			std::cerr << "chunk [" << position.x << ", " << position.y << "] is too large to be saved" << std::endl;
+			return false;
+		}
+
+		std::unique_lock lock(mutex);
+
+		// the old sectors are still in use until the new location is written, so they're never reused here
+		uint32_t offset = allocate(count);
+		if (!file->write(offset * SECTOR_SIZE, data) || !file->sync())
+			return false;
+
+		if (offset + count > usedSectors.size())
+			usedSectors.resize(offset + count, false);
+		for (uint32_t sector = offset; sector < offset + count; sector++)
+			usedSectors[sector] = true;
+
+		int i = index(position);
+		uint32_t location = offset << 8 | count;
+		uint32_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+		// a 4 byte write within a sector, which the disk writes as a whole
+		std::array<uint8_t, 4> entry{};
+		IO::writeLittleEndian(std::span(entry), 0, location);
+		if (!file->write(i * 4, entry) || !file->sync())
+			return false;
+
+		// the timestamp is informational, so it doesn't need its own sync
+		IO::writeLittleEndian(std::span(entry), 0, timestamp);
+		file->write(SECTOR_SIZE + i * 4, entry);
+
+		uint32_t oldLocation = std::exchange(locations[i], location);
+		timestamps[i] = timestamp;
+		for (uint32_t sector = sectorOffset(oldLocation); sector < sectorOffset(oldLocation) + sectorCount(oldLocation); sector++)
+			usedSectors[sector] = false;
+
+		return true;
+	}
+
+	uint32_t RegionFile::getTimestamp(glm::ivec2 position) const {
+		std::shared_lock lock(mutex);
+		return timestamps[index(position)];
+	}
+
+	size_t RegionFile::getSectorCount() const {
+		std::shared_lock lock(mutex);
+		return usedSectors.size();
+	}
+
+	size_t RegionFile::getUsedSectorCount() const {
+		std::shared_lock lock(mutex);
+		return std::count(usedSectors.begin(), usedSectors.end(), true);
+	}
+
+	glm::ivec2 RegionFile::regionPosition(glm::ivec2 chunkPosition) {
+		// arithmetic shifts round towards negative infinity
+		return { chunkPosition.x >> 5, chunkPosition.y >> 5 };
+	}
+
+	int RegionFile::index(glm::ivec2 chunkPosition) {
+		return (chunkPosition.y & (SIZE - 1)) * SIZE + (chunkPosition.x & (SIZE - 1));
+	}
+
+	uint32_t RegionFile::allocate(uint32_t count) const {
+		uint32_t runStart = 0;
+		uint32_t runLength = 0;
+		for (uint32_t sector = HEADER_SECTORS; sector < usedSectors.size(); sector++) {
+			if (usedSectors[sector]) {
+				runLength = 0;
+				continue;
+			}
+
+			if (runLength++ == 0)
+				runStart = sector;
+			if (runLength == count)
+				return runStart;
+		}
+
+		// a free run at the end of the file can be extended past it
+		return runLength > 0 ? runStart : uint32_t(usedSectors.size());
+	}
+
+	RegionStorage::RegionStorage(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+	std::shared_ptr<Chunk> RegionStorage::load(glm::ivec2 position) {
+		std::shared_ptr<RegionFile> region = getRegion(RegionFile::regionPosition(position), false);
+		if (!region)
+			return nullptr;
+
+		return region->read(position);
+	}
+
+	bool RegionStorage::save(const Chunk& chunk) {
+		std::shared_ptr<RegionFile> region = getRegion(RegionFile::regionPosition(chunk.getPosition()), true);
+		if (!region)
+			return false;
+
+		return region->write(chunk);
+	}
+
+	const std::filesystem::path& RegionStorage::getDirectory() const {
+		return directory;
+	}
+
+	size_t RegionStorage::getRegionCount() const {
+		std::lock_guard lock(mutex);
+		return regions.size();
+	}
+
+	std::shared_ptr<RegionFile> RegionStorage::getRegion(glm::ivec2 regionPosition, bool create) {
+		std::lock_guard lock(mutex);
+
+		auto it = regions.find(regionPosition);
+		if (it != regions.end())
+			return it->second;
+
+		std::filesystem::path path = directory / std::format("r.{}.{}.mcr", regionPosition.x, regionPosition.y);
+		if (!create && !std::filesystem::exists(path))
+			return nullptr;
+
+		std::shared_ptr<RegionFile> region = RegionFile::open(path);
+		if (region)
+			regions[regionPosition] = region;
+
+		return region;
+	}
+}
@@ -0,0 +1,305 @@
+#include "renderState.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+
+namespace Minecraft::Render {
+	namespace {
+		GLenum getEnum(GLenum name) {
+			GLint value = 0;
+			glGetIntegerv(name, &value);
+			return value;
+		}
+
+		/// removes every binding to one of the deleted objects, GL does the same
+		template<typename Map, typename Object>
+		void forget(Map& bindings, GLsizei count, const GLuint* objects, Object object) {
+			std::erase_if(bindings, [count, objects, &object](const auto& binding) {
+				return std::find(objects, objects + count, object(binding.second)) != objects + count;
+			});
+		}
+	}
+
+	RenderState::RenderState() {
+		reset();
+	}
+
+	RenderState& RenderState::get() {
+		static RenderState state;
+		return state;
+	}
+
+	void RenderState::reset() {
+		capabilities.clear();
+
+		depthFunc = getEnum(GL_DEPTH_FUNC);
+		blendFunc = {
+			getEnum(GL_BLEND_SRC_RGB), getEnum(GL_BLEND_DST_RGB),
+			getEnum(GL_BLEND_SRC_ALPHA), getEnum(GL_BLEND_DST_ALPHA),
+		};
+		blendEquation = { getEnum(GL_BLEND_EQUATION_RGB), getEnum(GL_BLEND_EQUATION_ALPHA) };
+		glGetFloatv(GL_BLEND_COLOR, glm::value_ptr(blendColor));
+		cullFace = getEnum(GL_CULL_FACE_MODE);
+		frontFace = getEnum(GL_FRONT_FACE);
+		{
+			// core profiles return the same mode twice, older drivers only write the first
+			GLint modes[2] = { GL_FILL, GL_FILL };
+			glGetIntegerv(GL_POLYGON_MODE, modes);
+			polygonMode = modes[0];
+		}
+		glGetFloatv(GL_POINT_SIZE, &pointSize);
+		glGetFloatv(GL_LINE_WIDTH, &lineWidth);
+
+		program = getEnum(GL_CURRENT_PROGRAM);
+		vertexArray = getEnum(GL_VERTEX_ARRAY_BINDING);
+		buffers.clear();
+		bufferRanges.clear();
+		textures.clear();
+	}
+
+	bool RenderState::isRedundant(bool unchanged) {
+		if (unchanged)
+			stats.elided++;
+		else
+			stats.issued++;
+
+		return unchanged;
+	}
+
+	void RenderState::setEnabled(GLenum capability, bool enabled) {
+		auto it = capabilities.find(capability);
+		if (isRedundant(it != capabilities.end() && it->second == enabled))
+			return;
+
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+
+		capabilities[capability] = enabled;
+	}
+
+	bool RenderState::isEnabled(GLenum capability) {
+		auto it = capabilities.find(capability);
+		if (it == capabilities.end())
+			it = capabilities.emplace(capability, glIsEnabled(capability) == GL_TRUE).first;
+
+		return it->second;
+	}
+
+	void RenderState::setDepthFunc(GLenum function) {
+		if (isRedundant(depthFunc == function))
+			return;
+
+		glDepthFunc(function);
+		depthFunc = function;
+	}
+
+	GLenum RenderState::getDepthFunc() const {
+		return depthFunc;
+	}
+
+	void RenderState::setBlendFunc(const BlendFunc& function) {
+		if (isRedundant(blendFunc == function))
+			return;
+
+		glBlendFuncSeparate(function.sourceRGB, function.destinationRGB, function.sourceAlpha, function.destinationAlpha);
+		blendFunc = function;
+	}
+
+	BlendFunc RenderState::getBlendFunc() const {
+		return blendFunc;
+	}
+
+	void RenderState::setBlendEquation(const BlendEquation& equation) {
+		if (isRedundant(blendEquation == equation))
+			return;
+
+		glBlendEquationSeparate(equation.rgb, equation.alpha);
+		blendEquation = equation;
+	}
+
+	BlendEquation RenderState::getBlendEquation() const {
+		return blendEquation;
+	}
+
+	void RenderState::setBlendColor(const glm::vec4& color) {
+		if (isRedundant(blendColor == color))
+			return;
+
+		glBlendColor(color.r, color.g, color.b, color.a);
+		blendColor = color;
+	}
+
+	glm::vec4 RenderState::getBlendColor() const {
+		return blendColor;
+	}
+
+	void RenderState::setCullFace(GLenum face) {
+		if (isRedundant(cullFace == face))
+			return;
+
+		glCullFace(face);
+		cullFace = face;
+	}
+
+	GLenum RenderState::getCullFace() const {
+		return cullFace;
+	}
+
+	void RenderState::setFrontFace(GLenum orientation) {
+		if (isRedundant(frontFace == orientation))
+			return;
+
+		glFrontFace(orientation);
+		frontFace = orientation;
+	}
+
+	GLenum RenderState::getFrontFace() const {
+		return frontFace;
+	}
+
+	void RenderState::setPolygonMode(GLenum mode) {
+		if (isRedundant(polygonMode == mode))
+			return;
+
+		glPolygonMode(GL_FRONT_AND_BACK, mode);
+		polygonMode = mode;
+	}
+
+	GLenum RenderState::getPolygonMode() const {
+		return polygonMode;
+	}
+
+	void RenderState::setPointSize(float size) {
+		if (isRedundant(pointSize == size))
+			return;
+
+		glPointSize(size);
+		pointSize = size;
+	}
+
+	float RenderState::getPointSize() const {
+		return pointSize;
+	}
+
+	void RenderState::setLineWidth(float width) {
+		if (isRedundant(lineWidth == width))
+			return;
+
+		glLineWidth(width);
+		lineWidth = width;
+	}
+
+	float RenderState::getLineWidth() const {
+		return lineWidth;
+	}
+
+	void RenderState::useProgram(GLuint program) {
+		if (isRedundant(this->program == program))
+			return;
+
+		glUseProgram(program);
+		this->program = program;
+	}
+
+	GLuint RenderState::getProgram() const {
+		return program;
+	}
+
+	void RenderState::bindVertexArray(GLuint vertexArray) {
+		if (isRedundant(this->vertexArray == vertexArray))
+			return;
+
+		glBindVertexArray(vertexArray);
+		this->vertexArray = vertexArray;
+	}
+
+	GLuint RenderState::getVertexArray() const {
+		return vertexArray;
+	}
+
+	void RenderState::bindBuffer(GLenum target, GLuint buffer) {
+		if (target == GL_ELEMENT_ARRAY_BUFFER) {
+			isRedundant(false);
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		auto it = buffers.find(target);
+		if (isRedundant(it != buffers.end() && it->second == buffer))
+			return;
+
+		glBindBuffer(target, buffer);
+		buffers[target] = buffer;
+	}
+
+	void RenderState::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+		BufferRange range = { buffer, offset, size };
+		auto it = bufferRanges.find({ target, index });
+		if (isRedundant(it != bufferRanges.end() && it->second == range))
+			return;
+
+		if (size == 0)
+			glBindBufferBase(target, index, buffer);
+		else
+			glBindBufferRange(target, index, buffer, offset, size);
+
+		bufferRanges[{ target, index }] = range;
+		buffers[target] = buffer;
+	}
+
+	void RenderState::bindTexture(GLuint unit, GLuint texture) {
+		auto it = textures.find(unit);
+		if (isRedundant(it != textures.end() && it->second == texture))
+			return;
+
+		glBindTextureUnit(unit, texture);
+		textures[unit] = texture;
+	}
+
+	GLuint RenderState::getTexture(GLuint unit) const {
+		auto it = textures.find(unit);
+		if (it == textures.end())
+			return 0;
+
+		return it->second;
+	}
+
+	void RenderState::deleteBuffers(GLsizei count, const GLuint* buffers) {
+		glDeleteBuffers(count, buffers);
+
+		forget(this->buffers, count, buffers, [](GLuint buffer) { return buffer; });
+		forget(bufferRanges, count, buffers, [](const BufferRange& range) { return range.buffer; });
+	}
+
+	void RenderState::deleteVertexArrays(GLsizei count, const GLuint* vertexArrays) {
+		glDeleteVertexArrays(count, vertexArrays);
+
+		if (std::find(vertexArrays, vertexArrays + count, vertexArray) != vertexArrays + count)
+			vertexArray = 0;
+	}
+
+	void RenderState::deleteTextures(GLsizei count, const GLuint* textures) {
+		glDeleteTextures(count, textures);
+
+		forget(this->textures, count, textures, [](GLuint texture) { return texture; });
+	}
+
+	void RenderState::deleteProgram(GLuint program) {
+		// a program in use is only deleted once it's no longer used, which would never happen if the use is elided
+		if (this->program == program)
+			useProgram(0);
+
+		glDeleteProgram(program);
+	}
+
+	RenderStateStats RenderState::getStats() const {
+		return stats;
+	}
+
+	void RenderState::resetStats() {
+		stats = {};
+	}
+}
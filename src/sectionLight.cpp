@@ -0,0 +1,23 @@
+#include "chunk.h"
+
+#include <algorithm>
+
+namespace Minecraft::World {
+	SectionLight::SectionLight(uint8_t skyLevel) {
+		block.fill(0);
+		sky.fill(skyLevel * 0x11);
+	}
+
+	const SectionLight& SectionLight::dark() {
+		static const SectionLight light(0);
+		return light;
+	}
+
+	bool SectionLight::isUniform(uint8_t skyLevel) const {
+		auto isFilledWith = [](const Levels& levels, uint8_t level) {
+			return std::ranges::all_of(levels, [pair = uint8_t(level * 0x11)](uint8_t value) { return value == pair; });
+		};
+
+		return isFilledWith(block, 0) && isFilledWith(sky, skyLevel);
+	}
+}
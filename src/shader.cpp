@@ -3,9 +3,38 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <utility>
 
 namespace Minecraft::Assets {
-	Shader::Shader(GLenum shaderType) : shader(glCreateShader(shaderType)) {
+	namespace {
+		std::string readFile(const std::filesystem::path& path) {
+			uintmax_t size = std::filesystem::file_size(path);
+			std::string str(size, '\0');
+			std::ifstream in(path);
+			in.read(str.data(), size);
+			return str;
+		}
+
+		/// prints the info log when the compile failed
+		bool checkCompileStatus(GLuint shader) {
+			GLint error = 0;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &error);
+			if (error == GL_FALSE) {
+				int length = 0;
+				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+				std::string errorMessage(length, '\0');
+				int writtenCount = 0;
+				glGetShaderInfoLog(shader, length, &writtenCount, errorMessage.data());
+				std::cerr << "shader compiled with error:\n" << errorMessage << std::endl;
+
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	Shader::Shader(GLenum shaderType) : shader(glCreateShader(shaderType)), type(shaderType) {
 		if (shader == 0) {
 			GLenum error = glGetError();
 			if (error == GL_INVALID_ENUM)
@@ -20,14 +49,22 @@ namespace Minecraft::Assets {
 	Shader::Shader(Shader&& other) noexcept {
 		if (shader != 0)
 			glDeleteShader(shader);
+		if (pending != 0)
+			glDeleteShader(pending);
 
 		this->shader = other.shader;
-		this->lastTimeStamp = other.lastTimeStamp;
+		this->type = other.type;
+		this->source = std::move(other.source);
+		this->compiled = other.compiled;
+		this->pending = other.pending;
+		this->pendingSource = std::move(other.pendingSource);
+		this->watch = std::move(other.watch);
 		this->path = other.path;
 		this->programs = other.programs;
 
 		other.shader = 0;
-		other.lastTimeStamp = std::filesystem::file_time_type::min();
+		other.compiled = false;
+		other.pending = 0;
 		other.path = {};
 		other.programs = {};
 	}
@@ -36,14 +73,22 @@ namespace Minecraft::Assets {
 		if (this != &other) {
 			if (shader != 0)
 				glDeleteShader(shader);
+			if (pending != 0)
+				glDeleteShader(pending);
 
 			this->shader = other.shader;
-			this->lastTimeStamp = other.lastTimeStamp;
+			this->type = other.type;
+			this->source = std::move(other.source);
+			this->compiled = other.compiled;
+			this->pending = other.pending;
+			this->pendingSource = std::move(other.pendingSource);
+			this->watch = std::move(other.watch);
 			this->path = other.path;
 			this->programs = other.programs;
 
 			other.shader = 0;
-			other.lastTimeStamp = std::filesystem::file_time_type::min();
+			other.compiled = false;
+			other.pending = 0;
 			other.path = {};
 			other.programs = {};
 		}
@@ -53,40 +98,54 @@ namespace Minecraft::Assets {
 	Shader::~Shader() {
 		if (shader != 0)
 			glDeleteShader(shader);
+		if (pending != 0)
+			glDeleteShader(pending);
 	}
 
 	bool Shader::update() {
-		bool isChanged = false;
-		if (path) {
-			// reload shader if file has changed
-			std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(*path);
-			if (lastWriteTime > lastTimeStamp) {
-				std::shared_ptr<Shader> other = parse(*path);
-				if (!other) {
-					std::cerr << "Failed to recompile changed shader, keeping old one" << std::endl;
-					lastTimeStamp = lastWriteTime; // make sure next frame we don't try to parse the file again
-				} else {
-					isChanged = true;
-
-					std::swap(*this, *other);
-					std::swap(this->programs, other->programs);
-
-					for (const std::weak_ptr<Program>& _program : programs) {
-						if (auto program = _program.lock()) {
-							if (std::any_of(program->shaders.begin(), program->shaders.end(), [this](const std::shared_ptr<Shader>& shader) { return shader->shader == this->shader; })) {
-								glDetachShader(program->program, other->shader);
-								glAttachShader(program->program, this->shader);
-
-								program->link();
-							}
-						}
-					}
-				}
-			}
+		if (watch && watch->poll())
+			recompile();
+
+		if (pending == 0)
+			return false;
+
+		// asking for the compile status would wait for the compile to finish
+		if (GLEW_ARB_parallel_shader_compile || GLEW_KHR_parallel_shader_compile) {
+			GLint isDone = GL_FALSE;
+			glGetShaderiv(pending, GL_COMPLETION_STATUS_ARB, &isDone);
+			if (isDone == GL_FALSE)
+				return false;
+		}
+
+		return swapPending();
+	}
+
+	void Shader::recompile() {
+		if (!path || !std::filesystem::exists(*path))
+			return;
+
+		// a newer change replaces a recompile that hasn't finished yet
+		if (pending != 0)
+			glDeleteShader(pending);
+
+		pending = glCreateShader(type);
+
+		pendingSource = readFile(*path);
+		const char* sourceData = pendingSource.c_str();
+		glShaderSource(pending, 1, &sourceData, nullptr);
+		glCompileShader(pending);
+	}
+
+	bool Shader::swapPending() {
+		GLuint other = std::exchange(pending, 0);
+		if (!checkCompileStatus(other)) {
+			std::cerr << "Failed to recompile changed shader, keeping old one" << std::endl;
+			glDeleteShader(other);
+			return false;
 		}
 
 		// remove programs that have been deleted
-		std::erase_if(programs, [this](std::weak_ptr<Shader::Program> _program) {
+		std::erase_if(programs, [](const std::weak_ptr<Shader::Program>& _program) {
 			auto program = _program.lock();
 			if (!program)
 				return true;
@@ -101,42 +160,34 @@ namespace Minecraft::Assets {
 			return false;
 		});
 
-		return isChanged;
-	}
-
-	bool Shader::loadShaderSource(const std::string& source) {
-		const char* sourceData = source.c_str();
+		// swapped before relinking, the program binary cache keys programs by the source of their shaders
+		GLuint old = std::exchange(shader, other);
+		source = std::move(pendingSource);
+		compiled = true;
 
-		glShaderSource(shader, 1, &sourceData, nullptr);
-		{
-			GLint shaderSourceLength = 0;
-			glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &shaderSourceLength);
-			if (shaderSourceLength == 0) {
-				std::cerr << "could not upload shader source to OpenGL" << std::endl;
+		for (const std::weak_ptr<Program>& _program : programs) {
+			if (auto program = _program.lock()) {
+				if (std::any_of(program->shaders.begin(), program->shaders.end(), [this](const std::shared_ptr<Shader>& shader) { return shader.get() == this; })) {
+					glDetachShader(program->program, old);
+					glAttachShader(program->program, shader);
 
-				return false;
+					program->link();
+				}
 			}
 		}
 
-		glCompileShader(shader);
-		{
-			GLint error = 0;
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &error);
-			if (error == GL_FALSE) {
-				int length = 0;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-				std::string errorMessage(length, '\0');
-				int writtenCount = 0;
-				glGetShaderInfoLog(shader, length, &writtenCount, errorMessage.data());
-				std::cerr << "shader compiled with error:\n" << errorMessage << std::endl;
-
-				return false;
-			}
-		}
+		glDeleteShader(old);
 
 		return true;
 	}
 
+	bool Shader::loadShaderSource(const std::string& source) {
+		if (!setSource(source))
+			return false;
+
+		return compile();
+	}
+
 	bool Shader::loadShaderSource(const std::vector<std::string>& sources) {
 		size_t sourcesSize = sources.size();
 		if (sourcesSize == 0)
@@ -159,23 +210,10 @@ namespace Minecraft::Assets {
 			}
 		}
 
-		glCompileShader(shader);
-		{
-			GLint error = 0;
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &error);
-			if (error == GL_FALSE) {
-				int length = 0;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-				std::string errorMessage(length, '\0');
-				int writtenCount = 0;
-				glGetShaderInfoLog(shader, length, &writtenCount, errorMessage.data());
-				std::cerr << "shader compiled with error:\n" << errorMessage << std::endl;
-
-				return false;
-			}
-		}
-
-		return true;
+		source.clear();
+		for (const std::string& part : sources)
+			source += part;
+		return compile();
 	}
 
 	std::shared_ptr<Shader> Shader::parse(const std::filesystem::path& path) {
@@ -216,17 +254,12 @@ namespace Minecraft::Assets {
 			return std::shared_ptr<Shader>(nullptr);
 		}
 
-		uintmax_t size = std::filesystem::file_size(path);
-		std::string str(size, '\0');
-		std::ifstream in(path);
-		in.read(str.data(), size);
-
-		std::shared_ptr<Shader> shader = parse(str, shaderType);
-		if (!shader)
+		std::shared_ptr<Shader> shader = std::make_shared<Shader>(shaderType);
+		if (!shader->setSource(readFile(path)))
 			return std::shared_ptr<Shader>(nullptr);
 
 		shader->path = path;
-		shader->lastTimeStamp = std::filesystem::last_write_time(*shader->path);
+		shader->watch = IO::FileWatcher::get().watch(path);
 		return shader;
 	}
 
@@ -238,4 +271,29 @@ namespace Minecraft::Assets {
 		else
 			return std::shared_ptr<Shader>(nullptr);
 	}
+
+	bool Shader::setSource(const std::string& source) {
+		const char* sourceData = source.c_str();
+
+		glShaderSource(shader, 1, &sourceData, nullptr);
+		{
+			GLint shaderSourceLength = 0;
+			glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &shaderSourceLength);
+			if (shaderSourceLength == 0) {
+				std::cerr << "could not upload shader source to OpenGL" << std::endl;
+
+				return false;
+			}
+		}
+
+		this->source = source;
+		compiled = false;
+		return true;
+	}
+
+	bool Shader::compile() {
+		glCompileShader(shader);
+		compiled = checkCompileStatus(shader);
+		return compiled;
+	}
 }
@@ -1,9 +1,14 @@
 #include "shader.h"
+#include "cameraBuffer.h"
+#include "renderState.h"
 
 #include <glm/gtc/type_ptr.hpp>
 
 #include <iostream>
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
 
 namespace Minecraft::Assets {
 	ShaderProgram::ShaderProgram() : program(glCreateProgram()) {
@@ -13,10 +18,15 @@ namespace Minecraft::Assets {
 
 	ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept {
 		if (program != 0)
-			glDeleteProgram(program);
+			Render::RenderState::get().deleteProgram(program);
 
 		this->program = other.program;
 		this->shaders = other.shaders;
+		this->attributes = std::move(other.attributes);
+		this->binaryCache = std::move(other.binaryCache);
+		this->linked = other.linked;
+		this->uniformLocations = std::move(other.uniformLocations);
+		this->uniformValues = std::move(other.uniformValues);
 
 		other.program = 0;
 		other.shaders = {};
@@ -25,10 +35,15 @@ namespace Minecraft::Assets {
 	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
 		if (this != &other) {
 			if (program != 0)
-				glDeleteProgram(program);
+				Render::RenderState::get().deleteProgram(program);
 
 			this->program = other.program;
 			this->shaders = other.shaders;
+			this->attributes = std::move(other.attributes);
+			this->binaryCache = std::move(other.binaryCache);
+			this->linked = other.linked;
+			this->uniformLocations = std::move(other.uniformLocations);
+			this->uniformValues = std::move(other.uniformValues);
 
 			other.program = 0;
 			other.shaders = {};
@@ -38,7 +53,7 @@ namespace Minecraft::Assets {
 
 	ShaderProgram::~ShaderProgram() {
 		if (program != 0)
-			glDeleteProgram(program);
+			Render::RenderState::get().deleteProgram(program);
 	}
 
 	std::shared_ptr<ShaderProgram> ShaderProgram::create() {
@@ -138,35 +153,69 @@ namespace Minecraft::Assets {
 
 		// errors should all be handled already
 		glBindAttribLocation(program, index, name.c_str());
+		std::erase_if(attributes, [&name](const std::pair<GLuint, std::string>& attribute) { return attribute.second == name; });
+		attributes.emplace_back(index, name);
+
+		return shared_from_this();
+	}
+
+	std::shared_ptr<ShaderProgram> ShaderProgram::useBinaryCache(std::shared_ptr<ProgramBinaryCache> cache) {
+		binaryCache = std::move(cache);
 
 		return shared_from_this();
 	}
 
 	std::shared_ptr<ShaderProgram> ShaderProgram::link() {
-		glLinkProgram(program);
-		{
-			GLint isLinked = 0;
-			glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
-
-			if (isLinked == GL_FALSE) {
-				int length = 0;
-				glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
-				std::string errorMessage(length, '\0');
-				int writtenCount = 0;
-				glGetProgramInfoLog(program, length, &writtenCount, errorMessage.data());
-				std::cerr << "shader program linked with error:\n" << errorMessage << std::endl;
+		std::string key;
+		if (binaryCache && binaryCache->isSupported()) {
+			key = getBinaryKey();
+			linked = binaryCache->load(program, key);
+		} else
+			linked = false;
+
+		if (!linked) {
+			// shaders parsed from a file are only compiled once they are needed
+			for (const std::shared_ptr<Shader>& shader : shaders)
+				if (!shader->compiled)
+					shader->compile();
+
+			if (!key.empty())
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+			glLinkProgram(program);
+			{
+				GLint isLinked = 0;
+				glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+				linked = isLinked == GL_TRUE;
+
+				if (!linked) {
+					int length = 0;
+					glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+					std::string errorMessage(length, '\0');
+					int writtenCount = 0;
+					glGetProgramInfoLog(program, length, &writtenCount, errorMessage.data());
+					std::cerr << "shader program linked with error:\n" << errorMessage << std::endl;
+				}
 			}
+
+			if (linked && !key.empty())
+				binaryCache->store(program, key);
 		}
 
+		// relinking can move uniforms, and resets their values
+		cacheUniformLocations();
+		uniformValues.clear();
+
+		GLuint cameraBlock = glGetUniformBlockIndex(program, "Camera");
+		if (cameraBlock != GL_INVALID_INDEX)
+			glUniformBlockBinding(program, cameraBlock, CAMERA_BINDING);
+
 		return shared_from_this();
 	}
 
 	std::shared_ptr<ShaderProgram> ShaderProgram::use() {
-		GLint isLinked = 0;
-		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
-
-		if (isLinked == GL_TRUE)
-			glUseProgram(program);
+		if (linked)
+			Render::RenderState::get().useProgram(program);
 		else
 			std::cerr << "Attempted to use unlinked program" << std::endl;
 
@@ -183,15 +232,105 @@ namespace Minecraft::Assets {
 	}
 
 	GLint ShaderProgram::getUniform(const std::string& uniform) const {
-		return glGetUniformLocation(program, uniform.c_str());
+		auto it = uniformLocations.find(uniform);
+		if (it == uniformLocations.end())
+			return -1;
+
+		return it->second;
+	}
+
+	void ShaderProgram::setUniform(GLint uniform, bool val) { setUniform(uniform, int(val ? GL_TRUE : GL_FALSE)); }
+	void ShaderProgram::setUniform(GLint uniform, int val) {
+		float data = std::bit_cast<float>(val);
+		if (!isCached(uniform, &data, 1))
+			glProgramUniform1i(program, uniform, val);
+	}
+	void ShaderProgram::setUniform(GLint uniform, float val) {
+		if (!isCached(uniform, &val, 1))
+			glProgramUniform1f(program, uniform, val);
+	}
+	void ShaderProgram::setUniform(GLint uniform, const glm::mat4& val) {
+		if (!isCached(uniform, glm::value_ptr(val), 16))
+			glProgramUniformMatrix4fv(program, uniform, 1, GL_FALSE, glm::value_ptr(val));
+	}
+	void ShaderProgram::setUniform(GLint uniform, const glm::mat3& val) {
+		if (!isCached(uniform, glm::value_ptr(val), 9))
+			glProgramUniformMatrix3fv(program, uniform, 1, GL_FALSE, glm::value_ptr(val));
+	}
+	void ShaderProgram::setUniform(GLint uniform, const glm::vec4& val) {
+		if (!isCached(uniform, glm::value_ptr(val), 4))
+			glProgramUniform4f(program, uniform, val.x, val.y, val.z, val.w);
+	}
+	void ShaderProgram::setUniform(GLint uniform, const glm::vec3& val) {
+		if (!isCached(uniform, glm::value_ptr(val), 3))
+			glProgramUniform3f(program, uniform, val.x, val.y, val.z);
+	}
+	void ShaderProgram::setUniform(GLint uniform, const glm::vec2& val) {
+		if (!isCached(uniform, glm::value_ptr(val), 2))
+			glProgramUniform2f(program, uniform, val.x, val.y);
+	}
+
+	bool ShaderProgram::isCached(GLint uniform, const float* data, size_t size) {
+		// setting location -1 is silently ignored by opengl, so there is nothing to cache
+		if (uniform < 0)
+			return true;
+
+		UniformValue& value = uniformValues[uniform];
+		// compared bitwise, so NaN doesn't count as changed every time
+		if (value.size == size && std::memcmp(value.data.data(), data, size * sizeof(float)) == 0)
+			return true;
+
+		std::memcpy(value.data.data(), data, size * sizeof(float));
+		value.size = size;
+		return false;
 	}
 
-	void ShaderProgram::setUniform(GLint uniform, bool val) { glUniform1i(uniform, val ? GL_TRUE : GL_FALSE); }
-	void ShaderProgram::setUniform(GLint uniform, int val) { glUniform1i(uniform, val); }
-	void ShaderProgram::setUniform(GLint uniform, float val) { glUniform1f(uniform, val); }
-	void ShaderProgram::setUniform(GLint uniform, const glm::mat4& val) { glUniformMatrix4fv(uniform, 1, GL_FALSE, glm::value_ptr(val)); }
-	void ShaderProgram::setUniform(GLint uniform, const glm::mat3& val) { glUniformMatrix3fv(uniform, 1, GL_FALSE, glm::value_ptr(val)); }
-	void ShaderProgram::setUniform(GLint uniform, const glm::vec4& val) { glUniform4f(uniform, val.x, val.y, val.z, val.w); }
-	void ShaderProgram::setUniform(GLint uniform, const glm::vec3& val) { glUniform3f(uniform, val.x, val.y, val.z); }
-	void ShaderProgram::setUniform(GLint uniform, const glm::vec2& val) { glUniform2f(uniform, val.x, val.y); }
+	std::string ShaderProgram::getBinaryKey() const {
+		// sorted, so the order the shaders were attached in doesn't matter
+		std::vector<const Shader*> sorted;
+		for (const std::shared_ptr<Shader>& shader : shaders)
+			sorted.push_back(shader.get());
+		std::ranges::sort(sorted, [](const Shader* a, const Shader* b) { return a->type < b->type; });
+
+		std::string key;
+		for (const Shader* shader : sorted) {
+			key += std::format("shader {:x} {}\n", shader->type, shader->source.size());
+			key += shader->source;
+		}
+
+		std::vector<std::pair<GLuint, std::string>> sortedAttributes = attributes;
+		std::ranges::sort(sortedAttributes);
+		for (const auto& [index, name] : sortedAttributes)
+			key += std::format("attribute {} {}\n", index, name);
+
+		return key;
+	}
+
+	void ShaderProgram::cacheUniformLocations() {
+		uniformLocations.clear();
+
+		GLint uniformCount = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+		GLint maxLength = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::string name(maxLength, '\0');
+		for (GLint i = 0; i < uniformCount; i++) {
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(program, i, maxLength, &length, &size, &type, name.data());
+
+			std::string uniform = name.substr(0, length);
+			// members of uniform blocks don't have a location
+			GLint location = glGetUniformLocation(program, uniform.c_str());
+			if (location < 0)
+				continue;
+
+			uniformLocations[uniform] = location;
+			// arrays are reported as 'name[0]', but are usually set through 'name'
+			if (uniform.ends_with("[0]"))
+				uniformLocations[uniform.substr(0, uniform.size() - 3)] = location;
+		}
+	}
 }
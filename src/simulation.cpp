@@ -0,0 +1,150 @@
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "simulation.h"
+#include "profiler.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace Minecraft::Game {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		/// how quickly the state follows the input, higher is faster
+		constexpr float EASING = 12;
+
+		float angleDifference(float from, float to) {
+			return std::remainder(to - from, 2 * std::numbers::pi_v<float>);
+		}
+
+		float lerpAngle(float a, float b, float alpha) {
+			return std::remainder(a + angleDifference(a, b) * alpha, 2 * std::numbers::pi_v<float>);
+		}
+	}
+
+	glm::vec3 GameState::getCameraPosition() const {
+		glm::mat4 rotation = glm::yawPitchRoll(yaw + orbit, pitch, roll);
+		return target + glm::vec3(rotation * glm::vec4(0, 0, distance, 0));
+	}
+
+	glm::mat4 GameState::getView() const {
+		glm::mat4 rotation = glm::yawPitchRoll(yaw + orbit, pitch, roll);
+		return glm::lookAt(getCameraPosition(), target, glm::vec3(rotation * glm::vec4(0, 1, 0, 0)));
+	}
+
+	GameState GameState::interpolate(const GameState& a, const GameState& b, float alpha) {
+		GameState state = b;
+		state.time = a.time + (b.time - a.time) * alpha;
+		state.target = glm::mix(a.target, b.target, alpha);
+		state.distance = a.distance + (b.distance - a.distance) * alpha;
+		state.yaw = lerpAngle(a.yaw, b.yaw, alpha);
+		state.pitch = lerpAngle(a.pitch, b.pitch, alpha);
+		state.roll = lerpAngle(a.roll, b.roll, alpha);
+		state.orbit = lerpAngle(a.orbit, b.orbit, alpha);
+		return state;
+	}
+
+	Simulation::Simulation(const GameState& initial, double tickRate) :
+		snapshots({ initial, initial, Clock::now(), std::chrono::nanoseconds(int64_t(1e9 / tickRate)) }),
+		state(initial),
+		input{ initial.distance, initial.yaw, initial.pitch, initial.roll, 0 },
+		stepNanoseconds(int64_t(1e9 / tickRate)) {
+		thread = std::thread(&Simulation::run, this);
+	}
+
+	Simulation::~Simulation() {
+		{
+			std::lock_guard lock(wakeUpMutex);
+			running = false;
+		}
+		wakeUp.notify_all();
+
+		if (thread.joinable())
+			thread.join();
+	}
+
+	void Simulation::setInput(const Input& input) {
+		std::lock_guard lock(inputMutex);
+		this->input = input;
+	}
+
+	Input Simulation::getInput() const {
+		std::lock_guard lock(inputMutex);
+		return input;
+	}
+
+	GameState Simulation::sample(Clock::time_point now) {
+		snapshots.update();
+		const Snapshot& snapshot = snapshots.getFront();
+
+		// 0 right when the tick was due, 1 when the next one is, so what's shown lags a tick behind the simulation
+		float alpha = std::chrono::duration<float>(now - snapshot.time) / std::chrono::duration<float>(snapshot.step);
+		return GameState::interpolate(snapshot.previous, snapshot.current, std::clamp(alpha, 0.0f, 1.0f));
+	}
+
+	void Simulation::setTickRate(double tickRate) {
+		stepNanoseconds = int64_t(1e9 / std::max(tickRate, 1.0));
+	}
+
+	double Simulation::getTickRate() const {
+		return 1e9 / stepNanoseconds;
+	}
+
+	SimulationStats Simulation::getStats() const {
+		return { ticks, skippedTicks, std::chrono::nanoseconds(lastTickNanoseconds) };
+	}
+
+	void Simulation::run() {
+		Profiling::Profiler::get().setThreadName("simulation");
+
+		Clock::time_point next = Clock::now();
+		while (running) {
+			std::chrono::nanoseconds step(stepNanoseconds.load());
+			// the tick is shown from when it was due until the next one is, see 'sample'
+			Clock::time_point due = next;
+			next += step;
+
+			{
+				Profiling::CpuZone zone("tick");
+				Clock::time_point start = Clock::now();
+
+				GameState previous = state;
+				tick(state, getInput(), std::chrono::duration<float>(step).count());
+
+				Snapshot& snapshot = snapshots.getBack();
+				snapshot = { previous, state, due, step };
+				snapshots.publish();
+
+				lastTickNanoseconds = (Clock::now() - start).count();
+				ticks++;
+			}
+
+			// a few late ticks are caught up on by not waiting, after a longer stall the simulation continues from now
+			Clock::time_point now = Clock::now();
+			if (now - next > step * MAX_CATCH_UP_TICKS) {
+				skippedTicks += (now - next) / step;
+				next = now;
+			}
+
+			std::unique_lock lock(wakeUpMutex);
+			wakeUp.wait_until(lock, next, [this]() { return !running; });
+		}
+	}
+
+	void Simulation::tick(GameState& state, const Input& input, float step) {
+		state.tick++;
+		state.time += step;
+
+		// the same fraction of the remaining distance per second, whatever the tick rate is
+		float easing = 1 - std::exp(-EASING * step);
+		state.distance += (input.distance - state.distance) * easing;
+		state.yaw = lerpAngle(state.yaw, input.yaw, easing);
+		state.pitch = lerpAngle(state.pitch, input.pitch, easing);
+		state.roll = lerpAngle(state.roll, input.roll, easing);
+		state.orbit = std::remainder(state.orbit + input.orbitSpeed * step, 2 * std::numbers::pi_v<float>);
+	}
+}
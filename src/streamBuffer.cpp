@@ -0,0 +1,112 @@
+#include "streamBuffer.h"
+#include "glDebug.h"
+#include "renderState.h"
+
+#include <iostream>
+
+namespace Minecraft::Render {
+	StreamBuffer::StreamBuffer(size_t capacity) : capacity(capacity) {
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, capacity, nullptr, flags);
+		setLabel(GL_BUFFER, buffer, "stream buffer");
+		mapping = (uint8_t*) glMapNamedBufferRange(buffer, 0, capacity, flags);
+		if (!mapping)
+			std::cerr << "could not map stream buffer of " << capacity << " bytes" << std::endl;
+
+		stats.capacity = capacity;
+	}
+
+	StreamBuffer::~StreamBuffer() {
+		for (Frame& frame : frames)
+			glDeleteSync(frame.fence);
+
+		if (mapping)
+			glUnmapNamedBuffer(buffer);
+		RenderState::get().deleteBuffers(1, &buffer);
+	}
+
+	bool StreamBuffer::allocate(size_t size, size_t alignment, Allocation& allocation) {
+		if (!mapping || size > capacity)
+			return false;
+
+		uint64_t start = (writePosition + alignment - 1) / alignment * alignment;
+		// allocations are never split, so one that doesn't fit before the end of the buffer starts at the beginning
+		if (start % capacity + size > capacity)
+			start += capacity - start % capacity;
+		uint64_t end = start + size;
+
+		while (end - releasedPosition > capacity) {
+			// the space is taken by this frame, waiting won't free it
+			if (!waitOldestFrame()) {
+				stats.failedCount++;
+				return false;
+			}
+		}
+
+		allocation.data = mapping + start % capacity;
+		allocation.offset = start % capacity;
+
+		frameBytes += size;
+		writePosition = end;
+		return true;
+	}
+
+	void StreamBuffer::endFrame() {
+		// a frame without allocations has nothing to fence, so the release position simply stays behind
+		if (writePosition != (frames.empty() ? releasedPosition : frames.back().end))
+			frames.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), writePosition });
+
+		// frames the gpu has already finished don't need to be waited for later
+		while (!frames.empty()) {
+			GLenum result = glClientWaitSync(frames.front().fence, 0, 0);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+				break;
+
+			releasedPosition = frames.front().end;
+			glDeleteSync(frames.front().fence);
+			frames.pop_front();
+		}
+
+		stats.bytesLastFrame = frameBytes;
+		stats.bytesTotal += frameBytes;
+		stats.waitTimeLastFrame = frameWaitTime;
+		stats.waitTimeTotal += frameWaitTime;
+		stats.framesInFlight = frames.size();
+
+		frameBytes = 0;
+		frameWaitTime = {};
+	}
+
+	GLuint StreamBuffer::getBuffer() const {
+		return buffer;
+	}
+
+	StreamStats StreamBuffer::getStats() const {
+		return stats;
+	}
+
+	bool StreamBuffer::waitOldestFrame() {
+		if (frames.empty())
+			return false;
+
+		Frame& frame = frames.front();
+
+		auto start = std::chrono::steady_clock::now();
+		GLenum result = GL_TIMEOUT_EXPIRED;
+		// the first wait flushes, so the fence is guaranteed to be signaled eventually
+		for (GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT; result == GL_TIMEOUT_EXPIRED; flags = 0)
+			result = glClientWaitSync(frame.fence, flags, 1'000'000);
+		frameWaitTime += std::chrono::steady_clock::now() - start;
+		stats.waitCount++;
+
+		if (result == GL_WAIT_FAILED)
+			std::cerr << "waiting for the stream buffer fence failed" << std::endl;
+
+		releasedPosition = frame.end;
+		glDeleteSync(frame.fence);
+		frames.pop_front();
+		return true;
+	}
+}
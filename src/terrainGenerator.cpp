@@ -0,0 +1,186 @@
+#include "terrainGenerator.h"
+#include "block.h"
+
+#include <stb_perlin.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Minecraft::World {
+	namespace {
+		constexpr int SIZE = ChunkSection::SIZE;
+
+		constexpr int HEIGHT_OCTAVES = 4;
+		constexpr float HEIGHT_FREQUENCY = 1 / 256.0f;
+		constexpr float HEIGHT_AMPLITUDE = 32;
+
+		/// density noise is sampled on a coarse lattice and interpolated in between
+		constexpr int CELL_WIDTH = 4;
+		constexpr int CELL_HEIGHT = 8;
+		constexpr int CELLS = SIZE / CELL_WIDTH + 1;
+
+		constexpr int DENSITY_OCTAVES = 3;
+		constexpr float DENSITY_FREQUENCY = 1 / 48.0f;
+		/// how far from the heightmap the density noise can move the surface
+		constexpr int DENSITY_RANGE = 12;
+
+		constexpr int floorTo(int value, int step) {
+			return value >= 0 ? value / step * step : (value - step + 1) / step * step;
+		}
+	}
+
+	TerrainGenerator::TerrainGenerator(uint32_t seed) : seed(seed), densityNoise(seed) {
+		stone = BlockRegistry::find("stone");
+		dirt = BlockRegistry::find("dirt");
+		grass = BlockRegistry::find("grass");
+		sand = BlockRegistry::find("sand");
+	}
+
+	void TerrainGenerator::generate(Chunk& chunk) const {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		glm::ivec2 origin = chunk.getPosition() * SIZE;
+		std::array<int, ChunkSection::AREA> heights = generateHeightmap(chunk.getPosition());
+		auto [minHeight, maxHeight] = std::minmax_element(heights.begin(), heights.end());
+
+		// density only matters near the surface, everything below is stone and everything above is air
+		int bottom = std::max(0, floorTo(*minHeight - DENSITY_RANGE, CELL_HEIGHT));
+		int top = std::min(Chunk::HEIGHT, floorTo(*maxHeight + DENSITY_RANGE, CELL_HEIGHT) + CELL_HEIGHT);
+		int cellsY = (top - bottom) / CELL_HEIGHT + 1;
+
+		// evaluate the whole lattice as one batch, so the noise can use its vectorised path
+		size_t sampleCount = CELLS * CELLS * cellsY;
+		std::vector<float> xs(sampleCount);
+		std::vector<float> ys(sampleCount);
+		std::vector<float> zs(sampleCount);
+		std::vector<float> octave(sampleCount);
+		std::vector<float> density(sampleCount, 0);
+
+		float amplitude = 0.5f;
+		float frequency = DENSITY_FREQUENCY;
+		for (int o = 0; o < DENSITY_OCTAVES; o++) {
+			// offset every octave, so their lattice points don't line up
+			float offset = o * 71.3f;
+
+			size_t i = 0;
+			for (int cy = 0; cy < cellsY; cy++) {
+				for (int cz = 0; cz < CELLS; cz++) {
+					for (int cx = 0; cx < CELLS; cx++, i++) {
+						xs[i] = (origin.x + cx * CELL_WIDTH) * frequency + offset;
+						ys[i] = (bottom + cy * CELL_HEIGHT) * frequency + offset;
+						zs[i] = (origin.y + cz * CELL_WIDTH) * frequency + offset;
+					}
+				}
+			}
+
+			densityNoise.sample(xs.data(), ys.data(), zs.data(), octave.data(), sampleCount);
+			for (size_t j = 0; j < sampleCount; j++)
+				density[j] += octave[j] * amplitude;
+
+			amplitude /= 2;
+			frequency *= 2;
+		}
+
+		auto lattice = [&density](int cx, int cy, int cz) { return density[(cy * CELLS + cz) * CELLS + cx]; };
+
+		std::vector<BlockId> blocks(Chunk::HEIGHT * ChunkSection::AREA, AIR);
+		auto blockIndex = [](int x, int y, int z) { return (y * SIZE + z) * SIZE + x; };
+
+		for (int z = 0; z < SIZE; z++) {
+			for (int x = 0; x < SIZE; x++) {
+				int height = heights[x + z * SIZE];
+
+				for (int y = 0; y < bottom; y++)
+					blocks[blockIndex(x, y, z)] = stone;
+
+				int cx = x / CELL_WIDTH;
+				int cz = z / CELL_WIDTH;
+				float fx = (x % CELL_WIDTH) / (float) CELL_WIDTH;
+				float fz = (z % CELL_WIDTH) / (float) CELL_WIDTH;
+
+				for (int y = bottom; y < top; y++) {
+					int cy = (y - bottom) / CELL_HEIGHT;
+					float fy = ((y - bottom) % CELL_HEIGHT) / (float) CELL_HEIGHT;
+
+					float d00 = glm::mix(lattice(cx, cy, cz), lattice(cx + 1, cy, cz), fx);
+					float d10 = glm::mix(lattice(cx, cy + 1, cz), lattice(cx + 1, cy + 1, cz), fx);
+					float d01 = glm::mix(lattice(cx, cy, cz + 1), lattice(cx + 1, cy, cz + 1), fx);
+					float d11 = glm::mix(lattice(cx, cy + 1, cz + 1), lattice(cx + 1, cy + 1, cz + 1), fx);
+					float noise = glm::mix(glm::mix(d00, d10, fy), glm::mix(d01, d11, fy), fz);
+
+					if ((height - y) + noise * DENSITY_RANGE > 0)
+						blocks[blockIndex(x, y, z)] = stone;
+				}
+
+				// surface layers, counted from the first solid block below air
+				int depth = -1;
+				for (int y = top - 1; y >= 0; y--) {
+					BlockId& block = blocks[blockIndex(x, y, z)];
+					if (block == AIR) {
+						depth = -1;
+						continue;
+					}
+
+					depth++;
+					if (depth > 3)
+						continue;
+
+					bool isBeach = y < SEA_LEVEL + 2;
+					if (depth == 0)
+						block = isBeach ? sand : grass;
+					else
+						block = isBeach ? sand : dirt;
+				}
+			}
+		}
+
+		for (int sectionY = 0; sectionY * SIZE < top; sectionY++)
+			chunk.getOrCreateSection(sectionY).setBlocks(std::span<const BlockId, ChunkSection::VOLUME>(blocks.data() + sectionY * ChunkSection::VOLUME, ChunkSection::VOLUME));
+		chunk.trim();
+
+		generationNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		generatedCount++;
+	}
+
+	std::array<int, ChunkSection::AREA> TerrainGenerator::generateHeightmap(glm::ivec2 chunkPosition) const {
+		std::array<int, ChunkSection::AREA> heights;
+		glm::ivec2 origin = chunkPosition * SIZE;
+
+		for (int z = 0; z < SIZE; z++) {
+			for (int x = 0; x < SIZE; x++) {
+				float height = 0;
+				float amplitude = HEIGHT_AMPLITUDE;
+				float frequency = HEIGHT_FREQUENCY;
+				for (int o = 0; o < HEIGHT_OCTAVES; o++) {
+					// stb only uses the lower 8 bits of the seed, the y coordinate separates the rest of it
+					height += stb_perlin_noise3_seed((origin.x + x) * frequency, (seed >> 8) * 0.01f + o * 13.1f, (origin.y + z) * frequency, 0, 0, 0, seed + o) * amplitude;
+					amplitude /= 2;
+					frequency *= 2;
+				}
+
+				heights[x + z * SIZE] = glm::clamp(BASE_HEIGHT + (int) height, 1, Chunk::HEIGHT - DENSITY_RANGE - 1);
+			}
+		}
+
+		return heights;
+	}
+
+	uint32_t TerrainGenerator::getSeed() const {
+		return seed;
+	}
+
+	uint64_t TerrainGenerator::getGeneratedCount() const {
+		return generatedCount;
+	}
+
+	std::chrono::nanoseconds TerrainGenerator::getGenerationTime() const {
+		return std::chrono::nanoseconds(generationNanoseconds);
+	}
+
+	double TerrainGenerator::getThroughput() const {
+		if (generationNanoseconds == 0)
+			return 0;
+
+		return generatedCount / (generationNanoseconds / 1e9);
+	}
+}
@@ -1,33 +1,28 @@
 #include "texture.h"
+#include "image.h"
+#include "renderState.h"
 
-#include <stb_image.h>
-
-#include <fstream>
 #include <iostream>
 
 namespace Minecraft::Assets {
 	Texture2D::Texture2D(const uint8_t* data, int width, int height) : size({ width, height }) {
-		glGenTextures(1, &texture);
-
-		GLint previousTexture = 0;
-		glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
-		bind();
-
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		// created and filled without binding it, so whatever texture is bound stays bound
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
 
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureStorage2D(texture, 1, GL_RGBA8, size.x, size.y);
+		glTextureSubImage2D(texture, 0, 0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, data);
 
-		if (previousTexture != 0)
-			glBindTexture(GL_TEXTURE_2D, previousTexture);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	}
 
 	Texture2D::Texture2D(Texture2D&& other) noexcept {
 		if (texture != 0)
-			glDeleteTextures(1, &texture);
+			Render::RenderState::get().deleteTextures(1, &texture);
 
 		this->texture = other.texture;
 		this->size = std::move(other.size);
+		this->loaded = other.loaded;
 
 		other.texture = 0;
 		other.size = { 0, 0 };
@@ -36,10 +31,11 @@ namespace Minecraft::Assets {
 	Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
 		if (this != &other) {
 			if (texture != 0)
-				glDeleteTextures(1, &texture);
+				Render::RenderState::get().deleteTextures(1, &texture);
 
 			this->texture = other.texture;
 			this->size = std::move(other.size);
+			this->loaded = other.loaded;
 
 			other.texture = 0;
 			other.size = { 0, 0 };
@@ -49,44 +45,51 @@ namespace Minecraft::Assets {
 
 	Texture2D::~Texture2D() {
 		if (texture != 0)
-			glDeleteTextures(1, &texture);
+			Render::RenderState::get().deleteTextures(1, &texture);
 	}
 
 	std::shared_ptr<Texture2D> Texture2D::load(std::filesystem::path path) {
 		if (path.empty()) return std::shared_ptr<Texture2D>(nullptr);
-		if (path.has_parent_path() && path.parent_path() == "textures")
-			path = std::filesystem::path("assets") / path;
-		else if (!path.has_parent_path())
-			path = std::filesystem::path("assets") / "textures" / path;
+		path = resolve(path);
 
 		if (!std::filesystem::exists(path)) {
 			std::cout << "file '" << path.filename() << "' at '" << path.parent_path() << "' does not exist" << std::endl;
 			return std::shared_ptr<Texture2D>(nullptr);
 		}
 
-		int w = 0;
-		int h = 0;
+		if (std::shared_ptr<Image> image = Image::load(path))
+			return std::make_shared<Texture2D>(image->getData(), image->getSize().x, image->getSize().y);
 
-		uintmax_t size = std::filesystem::file_size(path);
-		uint8_t* rawData = new uint8_t[size];
-		std::ifstream in(path, std::ios::binary);
-		in.read((char*) rawData, size);
+		return nullptr;
+	}
 
-		const uint8_t* imgData = stbi_load_from_memory((uint8_t*) rawData, size, &w, &h, nullptr, 4);
-		delete[] rawData;
+	std::shared_ptr<Texture2D> Texture2D::placeholder() {
+		// magenta and black, so it's obvious it isn't the real texture
+		const uint8_t pixels[] = {
+			255, 0, 255, 255, 0, 0, 0, 255,
+			0, 0, 0, 255, 255, 0, 255, 255,
+		};
 
-		if (imgData) {
-			std::shared_ptr<Texture2D> texture = std::make_shared<Texture2D>(imgData, w, h);
-			stbi_image_free((void*) imgData);
-			return texture;
-		} else {
-			std::cerr << "couldn't load image: '" << stbi_failure_reason() << "'" << std::endl;
-			return nullptr;
-		}
+		std::shared_ptr<Texture2D> texture = std::make_shared<Texture2D>(pixels, 2, 2);
+		texture->loaded = false;
+		return texture;
+	}
+
+	std::filesystem::path Texture2D::resolve(std::filesystem::path path) {
+		if (path.has_parent_path() && path.parent_path() == "textures")
+			return std::filesystem::path("assets") / path;
+		else if (!path.has_parent_path())
+			return std::filesystem::path("assets") / "textures" / path;
+
+		return path;
 	}
 
 	void Texture2D::bind() {
-		glBindTexture(GL_TEXTURE_2D, texture);
+		Render::RenderState::get().bindTexture(0, texture);
+	}
+
+	bool Texture2D::isLoaded() const {
+		return loaded;
 	}
 
 	glm::ivec2 Texture2D::getSize() const {
@@ -96,4 +99,13 @@ namespace Minecraft::Assets {
 	GLuint Texture2D::getId() const {
 		return texture;
 	}
+
+	void Texture2D::replace(GLuint texture, glm::ivec2 size) {
+		if (this->texture != 0)
+			Render::RenderState::get().deleteTextures(1, &this->texture);
+
+		this->texture = texture;
+		this->size = size;
+		loaded = true;
+	}
 }
@@ -0,0 +1,146 @@
+#include "textureArray.h"
+#include "renderState.h"
+#include "textureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Minecraft::Assets {
+	TextureArray::~TextureArray() {
+		if (texture != 0)
+			Render::RenderState::get().deleteTextures(1, &texture);
+	}
+
+	std::shared_ptr<TextureArray> TextureArray::placeholder() {
+		// same as the placeholder of Texture2D
+		const uint8_t pixels[] = {
+			255, 0, 255, 255, 0, 0, 0, 255,
+			0, 0, 0, 255, 255, 0, 255, 255,
+		};
+		Image image(pixels, { 2, 2 });
+
+		std::shared_ptr<TextureArray> array(new TextureArray());
+		array->upload({ "placeholder" }, { image.mipChain() });
+		array->loaded = false;
+		return array;
+	}
+
+	std::map<std::string, std::filesystem::path> TextureArray::find(const std::filesystem::path& directory) {
+		std::map<std::string, std::filesystem::path> files;
+		if (!std::filesystem::is_directory(directory)) {
+			std::cerr << "texture directory '" << directory << "' does not exist" << std::endl;
+			return files;
+		}
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory)) {
+			if (!entry.is_regular_file())
+				continue;
+
+			std::filesystem::path extension = entry.path().extension();
+			if (extension == ".qoi")
+				files.insert_or_assign(entry.path().stem().string(), entry.path());
+			else if (extension == ".png")
+				files.emplace(entry.path().stem().string(), entry.path());
+		}
+
+		return files;
+	}
+
+	std::vector<Image> TextureArray::buildMipChain(const std::string& name, const Image& image, glm::ivec2 size) {
+		if (image.getSize() == size)
+			return image.mipChain();
+
+		std::cerr << "texture '" << name << "' is " << image.getSize().x << "x" << image.getSize().y <<
+			" instead of " << size.x << "x" << size.y << ", it's resized" << std::endl;
+		return image.resized(size).mipChain();
+	}
+
+	void TextureArray::upload(const std::vector<std::string>& names, const std::vector<std::vector<Image>>& mipChains, Render::StreamBuffer* stream) {
+		if (mipChains.empty() || mipChains[0].empty()) {
+			std::cerr << "texture array needs at least one layer" << std::endl;
+			return;
+		}
+
+		GLuint newTexture = 0;
+		glm::ivec2 newSize = mipChains[0][0].getSize();
+		int newLevelCount = mipChains[0].size();
+		GLsizei layerCount = mipChains.size();
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &newTexture);
+		glTextureStorage3D(newTexture, newLevelCount, GL_RGBA8, newSize.x, newSize.y, layerCount);
+
+		// every level is copied next to the same level of the other layers, so each level is uploaded in one call
+		std::vector<uint8_t> level;
+		for (int i = 0; i < newLevelCount; i++) {
+			glm::ivec2 levelSize = mipChains[0][i].getSize();
+			size_t layerBytes = size_t(levelSize.x) * levelSize.y * 4;
+
+			level.resize(layerBytes * layerCount);
+			for (GLsizei layer = 0; layer < layerCount; layer++)
+				std::memcpy(level.data() + layerBytes * layer, mipChains[layer][i].getData(), layerBytes);
+
+			uploadPixels(newTexture, GL_TEXTURE_2D_ARRAY, i, { 0, 0, 0 }, { levelSize, layerCount }, level.data(), stream);
+		}
+
+		// nearest up close to keep the pixels sharp, blended mips in the distance to stop shimmering
+		glTextureParameteri(newTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+		glTextureParameteri(newTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(newTexture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(newTexture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		{
+			GLfloat maxAnisotropy = 1;
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+			glTextureParameterf(newTexture, GL_TEXTURE_MAX_ANISOTROPY, std::min(maxAnisotropy, 8.0f));
+		}
+
+		if (texture != 0)
+			Render::RenderState::get().deleteTextures(1, &texture);
+		texture = newTexture;
+		size = newSize;
+		levelCount = newLevelCount;
+		loaded = true;
+
+		this->names = names;
+		layers.clear();
+		for (size_t i = 0; i < names.size(); i++)
+			if (!layers.emplace(names[i], i).second)
+				std::cerr << "texture '" << names[i] << "' is in the array more than once, only the first is found by name" << std::endl;
+	}
+
+	void TextureArray::bind(GLuint unit) {
+		Render::RenderState::get().bindTexture(unit, texture);
+	}
+
+	bool TextureArray::isLoaded() const {
+		return loaded;
+	}
+
+	int TextureArray::getLayer(const std::string& name) const {
+		auto it = layers.find(name);
+		if (it == layers.end())
+			return -1;
+
+		return it->second;
+	}
+
+	const std::vector<std::string>& TextureArray::getLayerNames() const {
+		return names;
+	}
+
+	glm::ivec2 TextureArray::getSize() const {
+		return size;
+	}
+
+	size_t TextureArray::getLayerCount() const {
+		return names.size();
+	}
+
+	int TextureArray::getLevelCount() const {
+		return levelCount;
+	}
+
+	GLuint TextureArray::getId() const {
+		return texture;
+	}
+}
@@ -0,0 +1,180 @@
+#include "textureLoader.h"
+#include "imageCache.h"
+#include "renderState.h"
+#include "streamBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace Minecraft::Assets {
+	namespace {
+		std::shared_ptr<Image> decode(const std::filesystem::path& path, ImageCache* cache) {
+			if (cache)
+				return cache->load(path);
+
+			return Image::load(path);
+		}
+	}
+
+	bool uploadPixels(GLuint texture, GLenum target, GLint level, glm::ivec3 offset, glm::ivec3 size, const uint8_t* data, Render::StreamBuffer* stream) {
+		if (target == GL_TEXTURE_2D)
+			size.z = 1;
+		size_t byteCount = size_t(size.x) * size.y * size.z * 4;
+
+		Render::StreamBuffer::Allocation allocation;
+		bool staged = stream != nullptr && stream->allocate(byteCount, 4, allocation);
+
+		const void* pixels = data;
+		if (staged) {
+			std::memcpy(allocation.data, data, byteCount);
+			Render::RenderState::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->getBuffer());
+			// with an unpack buffer bound the pointer is an offset into it
+			pixels = reinterpret_cast<const void*>(allocation.offset);
+		}
+
+		if (target == GL_TEXTURE_2D)
+			glTextureSubImage2D(texture, level, offset.x, offset.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		else
+			glTextureSubImage3D(texture, level, offset.x, offset.y, offset.z, size.x, size.y, size.z, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+		// every other pixel transfer would read from the stream buffer otherwise
+		if (staged)
+			Render::RenderState::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		return staged;
+	}
+
+	TextureLoader::TextureLoader(Jobs::JobSystem& jobs, Render::StreamBuffer& stream, ImageCache* cache) : jobs(jobs), stream(stream), cache(cache) {
+	}
+
+	std::shared_ptr<Texture2D> TextureLoader::load(std::filesystem::path path) {
+		std::shared_ptr<Texture2D> texture = Texture2D::placeholder();
+		path = Texture2D::resolve(path);
+
+		state->pending++;
+		// the texture is only referenced weakly, so dropping it before the load finishes skips the upload
+		jobs.submit([&jobs = jobs, &stream = stream, cache = cache, state = state, path, weakTexture = std::weak_ptr<Texture2D>(texture)]() {
+			auto start = std::chrono::steady_clock::now();
+			std::shared_ptr<Image> image = decode(path, cache);
+			state->decodeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+			if (!image) {
+				state->pending--;
+				state->failed++;
+				return;
+			}
+
+			jobs.submitToMainThread([&stream, state, image, weakTexture]() {
+				state->pending--;
+
+				std::shared_ptr<Texture2D> texture = weakTexture.lock();
+				if (!texture)
+					return;
+
+				GLuint id = 0;
+				glCreateTextures(GL_TEXTURE_2D, 1, &id);
+				glTextureStorage2D(id, 1, GL_RGBA8, image->getSize().x, image->getSize().y);
+				uploadPixels(id, GL_TEXTURE_2D, 0, { 0, 0, 0 }, { image->getSize(), 1 }, image->getData(), &stream);
+
+				glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+				texture->replace(id, image->getSize());
+
+				state->loaded++;
+				state->bytesUploaded += image->getByteSize();
+			});
+		}, Jobs::Priority::HIGH);
+
+		return texture;
+	}
+
+	std::shared_ptr<TextureArray> TextureLoader::loadArray(std::vector<ArraySource> sources, glm::ivec2 size) {
+		std::shared_ptr<TextureArray> array = TextureArray::placeholder();
+		if (sources.empty())
+			return array;
+
+		struct Load {
+			std::vector<ArraySource> sources;
+			/// per source, as a split source has a layer per tile
+			std::vector<std::vector<std::string>> names;
+			std::vector<std::vector<std::vector<Image>>> mipChains;
+			/// the job that brings this to 0 submits the upload, so nothing has to wait on the other jobs
+			std::atomic<size_t> remaining = 0;
+		};
+
+		std::shared_ptr<Load> load = std::make_shared<Load>();
+		load->sources = std::move(sources);
+		load->names.resize(load->sources.size());
+		load->mipChains.resize(load->sources.size());
+		load->remaining = load->sources.size();
+
+		state->pending++;
+		for (size_t i = 0; i < load->sources.size(); i++) {
+			jobs.submit([&jobs = jobs, &stream = stream, cache = cache, state = state, load, i, size, weakArray = std::weak_ptr<TextureArray>(array)]() {
+				const ArraySource& source = load->sources[i];
+
+				auto start = std::chrono::steady_clock::now();
+				if (std::shared_ptr<Image> image = decode(source.path, cache)) {
+					if (source.split) {
+						std::vector<Image> tiles = image->split(size);
+						for (size_t tile = 0; tile < tiles.size(); tile++) {
+							load->names[i].push_back(source.name + ":" + std::to_string(tile));
+							load->mipChains[i].push_back(TextureArray::buildMipChain(load->names[i].back(), tiles[tile], size));
+						}
+					} else {
+						load->names[i].push_back(source.name);
+						load->mipChains[i].push_back(TextureArray::buildMipChain(source.name, *image, size));
+					}
+				} else
+					state->failed++;
+				state->decodeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+				// acq_rel, so the last job sees what every other job wrote
+				if (load->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+					return;
+
+				jobs.submitToMainThread([&stream, state, load, weakArray]() {
+					state->pending--;
+
+					std::shared_ptr<TextureArray> array = weakArray.lock();
+					if (!array)
+						return;
+
+					std::vector<std::string> names;
+					std::vector<std::vector<Image>> mipChains;
+					for (size_t i = 0; i < load->sources.size(); i++) {
+						std::ranges::move(load->names[i], std::back_inserter(names));
+						std::ranges::move(load->mipChains[i], std::back_inserter(mipChains));
+					}
+					if (mipChains.empty()) {
+						std::cerr << "none of the textures of the array could be loaded" << std::endl;
+						return;
+					}
+
+					array->upload(names, mipChains, &stream);
+
+					state->loaded++;
+					for (const std::vector<Image>& mipChain : mipChains)
+						for (const Image& level : mipChain)
+							state->bytesUploaded += level.getByteSize();
+				});
+			}, Jobs::Priority::HIGH);
+		}
+
+		return array;
+	}
+
+	TextureLoaderStats TextureLoader::getStats() const {
+		return {
+			state->pending,
+			state->loaded,
+			state->failed,
+			std::chrono::nanoseconds(state->decodeNanoseconds),
+			state->bytesUploaded,
+		};
+	}
+
+}
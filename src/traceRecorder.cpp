@@ -0,0 +1,190 @@
+#include "traceRecorder.h"
+#include "profiler.h"
+
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace Minecraft::Profiling {
+	namespace {
+		std::string escape(std::string_view string) {
+			std::string escaped;
+			for (char c : string) {
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				if (uint8_t(c) >= 0x20)
+					escaped += c;
+			}
+			return escaped;
+		}
+	}
+
+	TraceRecorder::~TraceRecorder() {
+		stop();
+	}
+
+	TraceRecorder& TraceRecorder::get() {
+		static TraceRecorder recorder;
+		return recorder;
+	}
+
+	bool TraceRecorder::start(const std::filesystem::path& path) {
+		stop();
+
+		if (path.has_parent_path()) {
+			std::error_code error;
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+
+		out.open(path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			std::cerr << "could not open '" << path << "' to write a trace to" << std::endl;
+			return false;
+		}
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		isFirstEvent = true;
+		written = 0;
+		dropped = 0;
+
+		// whatever a thread pushed after the last recording stopped doesn't belong to this one
+		{
+			std::lock_guard lock(ringsMutex);
+			for (const std::shared_ptr<Ring>& ring : rings)
+				ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+		}
+
+		recordingStart = Profiler::now();
+		recording = true;
+		writer = std::thread(&TraceRecorder::run, this);
+		return true;
+	}
+
+	void TraceRecorder::stop() {
+		if (!recording)
+			return;
+
+		{
+			std::lock_guard lock(writerMutex);
+			recording = false;
+		}
+		writerWakeUp.notify_all();
+		writer.join();
+
+		drain();
+
+		// names last, as threads can get their name during the recording
+		std::vector<std::string> threadNames = Profiler::get().getThreadNames();
+		auto writeName = [this](uint16_t track, const std::string& name) {
+			// a recording without any events only has these, which can't start with a separator
+			out << (isFirstEvent ? "" : ",\n");
+			isFirstEvent = false;
+
+			out << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", track, escape(name));
+			out << std::format(",\n{{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"sort_index\":{}}}}}", track, track);
+		};
+		for (size_t i = 0; i < threadNames.size(); i++)
+			writeName(i, threadNames[i]);
+		writeName(GPU_TRACK, "gpu");
+		writeName(FRAME_TRACK, "frames");
+
+		out << "\n]}\n";
+		out.close();
+	}
+
+	bool TraceRecorder::isRecording() const {
+		return recording.load(std::memory_order_relaxed);
+	}
+
+	void TraceRecorder::recordZone(const char* name, int64_t start, int64_t end, uint16_t track) {
+		push({ name, start, end, 0, track, Type::ZONE });
+	}
+
+	void TraceRecorder::recordCounter(const char* name, double value) {
+		// json has no infinity or nan, a single one would make the whole trace unreadable
+		if (!std::isfinite(value))
+			return;
+
+		int64_t now = Profiler::now();
+		push({ name, now, now, value, 0, Type::COUNTER });
+	}
+
+	TraceRecorderStats TraceRecorder::getStats() const {
+		return { written.load(), dropped.load() };
+	}
+
+	TraceRecorder::Ring& TraceRecorder::getRing() {
+		thread_local std::shared_ptr<Ring> ring = nullptr;
+		if (!ring) {
+			ring = std::make_shared<Ring>();
+
+			std::lock_guard lock(ringsMutex);
+			rings.push_back(ring);
+		}
+
+		return *ring;
+	}
+
+	void TraceRecorder::push(const Event& event) {
+		if (!isRecording())
+			return;
+
+		Ring& ring = getRing();
+		uint64_t head = ring.head.load(std::memory_order_relaxed);
+		if (head - ring.tail.load(std::memory_order_acquire) >= Ring::CAPACITY) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		ring.events[head % Ring::CAPACITY] = event;
+		ring.head.store(head + 1, std::memory_order_release);
+	}
+
+	void TraceRecorder::run() {
+		std::unique_lock lock(writerMutex);
+		while (recording) {
+			// often enough that a ring doesn't fill up, even with thousands of zones per frame
+			writerWakeUp.wait_for(lock, std::chrono::milliseconds(10));
+
+			lock.unlock();
+			drain();
+			lock.lock();
+		}
+	}
+
+	void TraceRecorder::drain() {
+		std::vector<std::shared_ptr<Ring>> current;
+		{
+			std::lock_guard lock(ringsMutex);
+			current = rings;
+		}
+
+		for (const std::shared_ptr<Ring>& ring : current) {
+			uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+			uint64_t head = ring->head.load(std::memory_order_acquire);
+			for (; tail < head; tail++)
+				write(ring->events[tail % Ring::CAPACITY]);
+			ring->tail.store(tail, std::memory_order_release);
+		}
+	}
+
+	void TraceRecorder::write(const Event& event) {
+		// microseconds since the recording started
+		double timestamp = (event.start - recordingStart) / 1000.0;
+
+		out << (isFirstEvent ? "" : ",\n");
+		isFirstEvent = false;
+
+		if (event.type == Type::ZONE)
+			out << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+				escape(event.name), event.track, timestamp, (event.end - event.start) / 1000.0);
+		else
+			out << std::format("{{\"name\":\"{}\",\"ph\":\"C\",\"pid\":1,\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}",
+				escape(event.name), timestamp, event.value);
+
+		written++;
+	}
+}
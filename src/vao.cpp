@@ -1,6 +1,6 @@
 #include "renderObject.h"
-
-#include <iostream>
+#include "glDebug.h"
+#include "renderState.h"
 
 namespace Minecraft::Assets {
 	VAO::VAO() {
@@ -9,7 +9,7 @@ namespace Minecraft::Assets {
 
 	VAO::VAO(VAO&& other) noexcept {
 		if (vao != 0)
-			glDeleteVertexArrays(1, &vao);
+			Render::RenderState::get().deleteVertexArrays(1, &vao);
 
 		this->vao = other.vao;
 		this->vbos = std::move(other.vbos);
@@ -23,7 +23,7 @@ namespace Minecraft::Assets {
 	VAO& VAO::operator=(VAO&& other) noexcept {
 		if (this != &other) {
 			if (vao != 0)
-				glDeleteVertexArrays(1, &vao);
+				Render::RenderState::get().deleteVertexArrays(1, &vao);
 
 			this->vao = other.vao;
 			this->vbos = std::move(other.vbos);
@@ -38,7 +38,7 @@ namespace Minecraft::Assets {
 
 	VAO::~VAO() {
 		if (vao != 0)
-			glDeleteVertexArrays(1, &vao);
+			Render::RenderState::get().deleteVertexArrays(1, &vao);
 	}
 
 	VAO VAO::create(const std::function<VBO()>& vbo) {
@@ -124,11 +124,11 @@ namespace Minecraft::Assets {
 	}
 
 	void VAO::bind() {
-		glBindVertexArray(vao);
+		Render::RenderState::get().bindVertexArray(vao);
 	}
 
 	void VAO::unbind() {
-		glBindVertexArray(0);
+		Render::RenderState::get().bindVertexArray(0);
 	}
 
 	void VAO::draw(GLenum shape) {
@@ -137,38 +137,6 @@ namespace Minecraft::Assets {
 			glDrawElements(shape, ebo->getSize(), GL_UNSIGNED_INT, 0);
 		else
 			glDrawArrays(shape, 0, vbos[0].getSize());
-		{
-			GLenum error = glGetError();
-			if (error == GL_INVALID_ENUM) {
-				std::cerr << "Rendershape is not valid, must be one of " <<
-					"'GL_POINTS', 'GL_LINE_STRIP', 'GL_LINE_LOOP', 'GL_LINES', 'GL_TRIANGLE_STRIP', 'GL_TRIANGLE_FAN', 'GL_TRIANGLES', 'GL_PATCHES'";
-				int version[] = { 3, 0 };
-				glGetIntegerv(GL_MAJOR_VERSION, &version[0]);
-				glGetIntegerv(GL_MINOR_VERSION, &version[1]);
-				if ((version[0] == 3 && version[1] >= 2) || version[0] > 3)
-					std::cerr << ", 'GL_LINE_STRIP_ADJACENCY', 'GL_LINES_ADJACENCY', 'GL_TRIANGLE_STRIP_ADJACENCY', 'GL_TRIANGLES_ADJACENCY'";
-
-				std::cerr << std::endl;
-			} else if (error == GL_INVALID_OPERATION) {
-				bool isMapped = false;
-				glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_MAPPED, (int*) &isMapped);
-
-				if (isMapped)
-					std::cerr << "Buffer is currently mapped for data access, and cannot be rendered" << std::endl;
-				else {
-					GLenum geometryShape = 0;
-					GLint currentProgram = 0;
-
-					glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-					glGetProgramiv(currentProgram, GL_GEOMETRY_INPUT_TYPE, (int*) &geometryShape);
-					if (geometryShape != shape)
-						std::cerr << "A geometry shader is present, and requires a certain rendershape" << std::endl;
-					else
-						std::cerr << (ebo ? "'glDrawElements'" : "'glDrawArrays'") << " caused 'GL_INVALID_OPERATION' error with unknown cause" << std::endl;
-				}
-			} else if (error != GL_NO_ERROR)
-				std::cerr << (ebo ? "'glDrawElements'" : "'glDrawArrays'") << " caused unchecked error" << std::endl;
-		}
-		unbind();
+		Render::checkDrawError(ebo ? "glDrawElements" : "glDrawArrays", shape);
 	}
 }
@@ -0,0 +1,81 @@
+#include "visibility.h"
+
+namespace Minecraft::World {
+	Visibility Visibility::compute(const ChunkSection& section) {
+		constexpr int SIZE = ChunkSection::SIZE;
+
+		if (section.isUniform())
+			return BlockRegistry::isOpaque(section.getBlock(0)) ? closed() : Visibility();
+
+		std::vector<bool> isOpen(ChunkSection::VOLUME);
+		for (int i = 0; i < ChunkSection::VOLUME; i++)
+			isOpen[i] = !BlockRegistry::isOpaque(section.getBlock(i));
+
+		Visibility visibility = closed();
+		std::vector<uint16_t> stack;
+
+		// faces of the section a block lies on, as bits in the order of 'Face'
+		auto borderFaces = [](glm::ivec3 pos) {
+			uint8_t faces = 0;
+			for (int axis = 0; axis < 3; axis++) {
+				if (pos[axis] == 0)
+					faces |= 1 << (axis * 2);
+				if (pos[axis] == SIZE - 1)
+					faces |= 1 << (axis * 2 + 1);
+			}
+			return faces;
+		};
+
+		for (int start = 0; start < ChunkSection::VOLUME; start++) {
+			// pockets that don't touch the border can't connect anything, so only fills starting at the border matter
+			if (!isOpen[start] || borderFaces(ChunkSection::position(start)) == 0)
+				continue;
+
+			uint8_t faces = 0;
+			isOpen[start] = false;
+			stack.push_back(start);
+			while (!stack.empty()) {
+				int index = stack.back();
+				stack.pop_back();
+
+				glm::ivec3 pos = ChunkSection::position(index);
+				faces |= borderFaces(pos);
+
+				for (int f = 0; f < FACE_COUNT; f++) {
+					glm::ivec3 next = pos + faceNormal(static_cast<Face>(f));
+					if (next.x < 0 || next.y < 0 || next.z < 0 || next.x >= SIZE || next.y >= SIZE || next.z >= SIZE)
+						continue;
+
+					int nextIndex = ChunkSection::index(next.x, next.y, next.z);
+					if (!isOpen[nextIndex])
+						continue;
+
+					// cleared when pushed, so every block is only pushed once
+					isOpen[nextIndex] = false;
+					stack.push_back(nextIndex);
+				}
+			}
+
+			for (int a = 0; a < FACE_COUNT; a++)
+				for (int b = 0; b < FACE_COUNT; b++)
+					if (faces & 1 << a && faces & 1 << b)
+						visibility.connect(static_cast<Face>(a), static_cast<Face>(b));
+		}
+
+		return visibility;
+	}
+
+	Visibility Visibility::closed() {
+		Visibility visibility;
+		visibility.connections = 0;
+		return visibility;
+	}
+
+	bool Visibility::isConnected(Face a, Face b) const {
+		return connections & bit(a, b);
+	}
+
+	void Visibility::connect(Face a, Face b) {
+		connections |= bit(a, b) | bit(b, a);
+	}
+}
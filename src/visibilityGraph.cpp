@@ -0,0 +1,66 @@
+#include "visibility.h"
+
+namespace Minecraft::World {
+	void VisibilityGraph::set(glm::ivec3 sectionPosition, Visibility visibility) {
+		sections.insert_or_assign(sectionPosition, visibility);
+	}
+
+	void VisibilityGraph::remove(glm::ivec2 chunkPosition) {
+		for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+			sections.erase({ chunkPosition.x, y, chunkPosition.y });
+	}
+
+	bool VisibilityGraph::contains(glm::ivec3 sectionPosition) const {
+		return sections.contains(sectionPosition);
+	}
+
+	const std::vector<glm::ivec3>& VisibilityGraph::findVisible(glm::ivec3 start, const Render::Frustum* frustum) {
+		visible.clear();
+		queue.clear();
+		visited.clear();
+
+		if (!sections.contains(start))
+			return visible;
+
+		// the start section is left through any face, as the camera can be anywhere inside of it
+		visible.push_back(start);
+		visited.insert(start);
+		queue.push_back({ start, Face::NEG_X, 0 });
+
+		for (size_t i = 0; i < queue.size(); i++) {
+			Node node = queue[i];
+			const Visibility& visibility = sections.at(node.position);
+			bool isStart = node.position == start;
+
+			for (int f = 0; f < FACE_COUNT; f++) {
+				Face exit = static_cast<Face>(f);
+
+				// going back towards the camera can only reach sections that are seen some other way
+				if (node.directions & 1 << static_cast<int>(opposite(exit)))
+					continue;
+				if (!isStart && !visibility.isConnected(node.entry, exit))
+					continue;
+
+				glm::ivec3 next = node.position + faceNormal(exit);
+				if (next.y < 0 || next.y >= Chunk::SECTION_COUNT || visited.contains(next) || !sections.contains(next))
+					continue;
+
+				if (frustum) {
+					glm::vec3 min(next * ChunkSection::SIZE);
+					if (!frustum->isVisible({ min, min + glm::vec3(ChunkSection::SIZE) }))
+						continue;
+				}
+
+				visited.insert(next);
+				visible.push_back(next);
+				queue.push_back({ next, opposite(exit), uint8_t(node.directions | 1 << f) });
+			}
+		}
+
+		return visible;
+	}
+
+	size_t VisibilityGraph::getSectionCount() const {
+		return sections.size();
+	}
+}
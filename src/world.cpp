@@ -0,0 +1,90 @@
+#include "world.h"
+
+#include <utility>
+
+namespace Minecraft::World {
+	namespace {
+		constexpr int floorDiv(int value, int divisor) {
+			return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+		}
+
+		constexpr int floorMod(int value, int divisor) {
+			return value - floorDiv(value, divisor) * divisor;
+		}
+	}
+
+	World::World(uint32_t seed, std::filesystem::path directory) : generator(seed), storage(std::move(directory)) {}
+
+	std::shared_ptr<Chunk> World::getChunk(glm::ivec2 position) const {
+		auto it = chunks.find(position);
+		if (it == chunks.end())
+			return nullptr;
+
+		return it->second;
+	}
+
+	bool World::hasChunk(glm::ivec2 position) const {
+		return chunks.contains(position);
+	}
+
+	void World::setChunk(std::shared_ptr<Chunk> chunk) {
+		glm::ivec2 position = chunk->getPosition();
+		chunks[position] = std::move(chunk);
+	}
+
+	void World::removeChunk(glm::ivec2 position) {
+		chunks.erase(position);
+	}
+
+	const ChunkSection* World::getSection(glm::ivec3 sectionPosition) const {
+		auto it = chunks.find({ sectionPosition.x, sectionPosition.z });
+		if (it == chunks.end())
+			return nullptr;
+
+		return it->second->getSection(sectionPosition.y);
+	}
+
+	BlockId World::getBlock(glm::ivec3 position) const {
+		auto it = chunks.find(chunkPosition(position));
+		if (it == chunks.end())
+			return AIR;
+
+		return it->second->getBlock(floorMod(position.x, ChunkSection::SIZE), position.y, floorMod(position.z, ChunkSection::SIZE));
+	}
+
+	BlockId World::setBlock(glm::ivec3 position, BlockId block) {
+		auto it = chunks.find(chunkPosition(position));
+		if (it == chunks.end())
+			return AIR;
+
+		return it->second->setBlock(floorMod(position.x, ChunkSection::SIZE), position.y, floorMod(position.z, ChunkSection::SIZE), block);
+	}
+
+	size_t World::getChunkCount() const {
+		return chunks.size();
+	}
+
+	size_t World::getMemoryUsage() const {
+		size_t usage = 0;
+		for (const auto& [position, chunk] : chunks)
+			usage += chunk->getMemoryUsage();
+
+		return usage;
+	}
+
+	const TerrainGenerator& World::getGenerator() const {
+		return generator;
+	}
+
+	RegionStorage& World::getStorage() {
+		return storage;
+	}
+
+	glm::ivec2 World::chunkPosition(glm::ivec3 position) {
+		return { floorDiv(position.x, ChunkSection::SIZE), floorDiv(position.z, ChunkSection::SIZE) };
+	}
+
+	glm::ivec3 World::sectionPosition(glm::ivec3 position) {
+		return { floorDiv(position.x, ChunkSection::SIZE), floorDiv(position.y, ChunkSection::SIZE), floorDiv(position.z, ChunkSection::SIZE) };
+	}
+}
@@ -0,0 +1,124 @@
+#include "block.h"
+#include "chunk.h"
+#include "regionFile.h"
+#include "terrainGenerator.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Minecraft;
+
+namespace {
+	constexpr uint32_t SEED = 1337;
+
+	/// spread over four regions, including negative coordinates and the corners of a region
+	constexpr std::array<glm::ivec2, 6> POSITIONS = { {
+		{ 0, 0 }, { 1, 0 }, { 31, 31 }, { 32, 0 }, { -1, -1 }, { -32, 5 },
+	} };
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& message) {
+		if (condition)
+			return;
+
+		std::cerr << "failed: " << message << std::endl;
+		failures++;
+	}
+
+	bool sameBlocks(const World::Chunk& a, const World::Chunk& b) {
+		for (int y = 0; y < World::Chunk::HEIGHT; y++)
+			for (int z = 0; z < World::ChunkSection::SIZE; z++)
+				for (int x = 0; x < World::ChunkSection::SIZE; x++)
+					if (a.getBlock(x, y, z) != b.getBlock(x, y, z))
+						return false;
+		return true;
+	}
+
+	std::string describe(glm::ivec2 position) {
+		return "chunk [" + std::to_string(position.x) + ", " + std::to_string(position.y) + "]";
+	}
+
+	/// flips a byte of the compressed chunk, past the header of its sectors
+	bool corruptPayload(const std::filesystem::path& path, glm::ivec2 position) {
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		int index = (position.y & (World::RegionFile::SIZE - 1)) * World::RegionFile::SIZE + (position.x & (World::RegionFile::SIZE - 1));
+
+		std::array<uint8_t, 4> location = {};
+		file.seekg(index * 4);
+		file.read((char*) location.data(), location.size());
+		uint32_t sector = location[1] | location[2] << 8 | location[3] << 16;
+		if (!file || sector == 0)
+			return false;
+
+		std::streamoff offset = sector * World::RegionFile::SECTOR_SIZE + 13 + 8;
+		char byte = 0;
+		file.seekg(offset);
+		file.get(byte);
+		file.seekp(offset);
+		file.put(char(byte ^ 0x5A));
+		return bool(file);
+	}
+}
+
+int main() {
+	World::BlockRegistry::registerDefaults();
+	World::TerrainGenerator generator(SEED);
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "minecraft_region_test";
+	std::filesystem::remove_all(directory);
+
+	std::vector<std::shared_ptr<World::Chunk>> chunks;
+	for (glm::ivec2 position : POSITIONS) {
+		std::shared_ptr<World::Chunk> chunk = std::make_shared<World::Chunk>(position);
+		generator.generate(*chunk);
+		chunks.push_back(chunk);
+	}
+	// a block the generator never places there, so a chunk that wasn't saved can't pass by being generated the same way
+	chunks[0]->setBlock(3, World::Chunk::HEIGHT - 1, 7, World::BlockRegistry::find("stone"));
+
+	{
+		World::RegionStorage storage(directory);
+		for (const std::shared_ptr<World::Chunk>& chunk : chunks)
+			check(storage.save(*chunk), "saving " + describe(chunk->getPosition()));
+		check(storage.getRegionCount() == 4, "chunks are stored in 4 regions");
+	}
+
+	{
+		World::RegionStorage storage(directory);
+		for (const std::shared_ptr<World::Chunk>& chunk : chunks) {
+			std::shared_ptr<World::Chunk> loaded = storage.load(chunk->getPosition());
+			check(loaded != nullptr, "loading " + describe(chunk->getPosition()));
+			if (loaded)
+				check(sameBlocks(*chunk, *loaded), describe(chunk->getPosition()) + " has the blocks it was saved with");
+		}
+		check(storage.load({ 2, 2 }) == nullptr, "a chunk that was never saved isn't loaded");
+	}
+
+	glm::ivec2 corrupted = POSITIONS[1];
+	check(corruptPayload(directory / "r.0.0.mcr", corrupted), "corrupting " + describe(corrupted));
+
+	{
+		World::RegionStorage storage(directory);
+		check(storage.load(corrupted) == nullptr, "damaged " + describe(corrupted) + " is rejected");
+		check(storage.load(POSITIONS[0]) != nullptr, "the other chunks of the damaged region still load");
+	}
+
+	std::filesystem::remove_all(directory);
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "all checks passed" << std::endl;
+	return 0;
+}